@@ -0,0 +1,430 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "BatchRunner.h"
+
+// nomacs
+#include "DkImageContainer.h"
+
+// ReadModules
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QAction>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QJsonObject>
+#include <QLibrary>
+#include <QPluginLoader>
+#include <QSettings>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <functional>
+#include <iostream>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+/**
+*	Constructor
+**/
+BatchRunner::BatchRunner() {
+
+	mNumThreads = QThread::idealThreadCount();
+}
+
+BatchRunner::~BatchRunner() {
+
+	if (mLoader) {
+		mLoader->unload();
+		delete mLoader;
+	}
+}
+
+/**
+* Loads the plugin from pluginDir.
+* @param pluginDir the directory containing the plugin libraries
+* @param pluginName either the file name, the PluginName (json) or the batch plugin's name()
+* @return true if the plugin was loaded
+**/
+bool BatchRunner::loadPlugin(const QString& pluginDir, const QString& pluginName) {
+
+	QString nName = normalizeName(pluginName);
+	QDir dir(pluginDir);
+
+	for (const QString& fn : dir.entryList(QDir::Files)) {
+
+		QString fp = dir.absoluteFilePath(fn);
+
+		if (!QLibrary::isLibrary(fp))
+			continue;
+
+		QPluginLoader* loader = new QPluginLoader(fp);
+		QJsonObject md = loader->metaData().value("MetaData").toObject();
+
+		bool match =
+			normalizeName(QFileInfo(fp).baseName()) == nName ||
+			normalizeName(md.value("PluginName").toString()) == nName ||
+			md.value("PluginId").toString() == pluginName;
+
+		QObject* obj = loader->instance();
+		nmc::DkBatchPluginInterface* bp = qobject_cast<nmc::DkBatchPluginInterface*>(obj);
+
+		// batch plugins can also be addressed by their name()
+		if (!match && bp)
+			match = normalizeName(bp->name()) == nName;
+
+		if (match && obj) {
+			mLoader = loader;
+			mPlugin = qobject_cast<nmc::DkPluginInterface*>(obj);
+			mBatchPlugin = bp;
+
+			// nomacs creates the actions when the plugin is loaded
+			if (mPlugin)
+				mPlugin->createActions(0);
+
+			return mPlugin != 0;
+		}
+
+		loader->unload();
+		delete loader;
+	}
+
+	qWarning() << "could not find" << pluginName << "in" << dir.absolutePath();
+	return false;
+}
+
+/**
+* Selects the plugin's action.
+* Most plugins create their run IDs at runtime, hence the action can
+* be specified either by its run ID, its menu name or its index.
+* @param run run ID, menu name (case insensitive) or action index
+* @return true if the action exists
+**/
+bool BatchRunner::setRun(const QString& run) {
+
+	if (!mPlugin)
+		return false;
+
+	QList<QAction*> actions = mPlugin->pluginActions();
+
+	bool isIdx = false;
+	int idx = run.toInt(&isIdx);
+
+	if (isIdx && idx >= 0 && idx < actions.size()) {
+		mRunID = actions[idx]->data().toString();
+		return true;
+	}
+
+	QString nRun = normalizeName(run);
+
+	for (const QAction* a : actions) {
+
+		if (a->data().toString() == run || normalizeName(a->text()) == nRun) {
+			mRunID = a->data().toString();
+			return true;
+		}
+	}
+
+	qWarning() << "unknown action:" << run;
+	return false;
+}
+
+void BatchRunner::setNumThreads(int numThreads) {
+	mNumThreads = qMax(numThreads, 1);
+}
+
+int BatchRunner::numThreads() const {
+	return mNumThreads;
+}
+
+void BatchRunner::setOutputDirectory(const QString & dir) {
+	mOutputDir = dir;
+}
+
+void BatchRunner::setSaveImages(bool save) {
+	mSaveImages = save;
+}
+
+void BatchRunner::setSettingsFilePath(const QString & filePath) {
+	mSettingsFilePath = filePath;
+}
+
+/**
+* Processes all files.
+* @param filePaths the images to be processed
+* @return the number of files that could not be processed
+**/
+int BatchRunner::run(const QStringList& filePaths) {
+
+	if (!mPlugin || mRunID.isEmpty()) {
+		qWarning() << "no plugin loaded - nothing to do";
+		return filePaths.size();
+	}
+
+	if (mSaveImages && mOutputDir.isEmpty()) {
+		qWarning() << "saving images requires an output directory - nothing to do";
+		return filePaths.size();
+	}
+
+	if (!mOutputDir.isEmpty())
+		QDir().mkpath(mOutputDir);
+
+	loadSettings();
+
+	mNumFiles = filePaths.size();
+	mNumProcessed = 0;
+	mNumFailed = 0;
+
+	QThreadPool::globalInstance()->setMaxThreadCount(mNumThreads);
+	print(QString("processing %1 files with %2 threads").arg(mNumFiles).arg(mNumThreads));
+
+	if (mBatchPlugin)
+		mBatchPlugin->preLoadPlugin();
+
+	mTimer.start();
+
+	std::function<QSharedPointer<nmc::DkBatchInfo>(const QString&)> f = [&](const QString& fp) {
+		return process(fp);
+	};
+	QList<QSharedPointer<nmc::DkBatchInfo> > infos = QtConcurrent::blockingMapped(filePaths, f);
+
+	double sec = mTimer.elapsed() / 1000.0;
+
+	if (mBatchPlugin) {
+
+		// nomacs does not pass empty infos
+		QVector<QSharedPointer<nmc::DkBatchInfo> > batchInfo;
+		for (auto bi : infos) {
+			if (bi)
+				batchInfo << bi;
+		}
+
+		mBatchPlugin->postLoadPlugin(batchInfo);
+	}
+
+	// plain plugins have no postLoadPlugin() - no-op if the plugin flushed already
+	Telemetry::instance().flush();
+
+	print(QString("%1 files processed in %2 sec (%3 pages/sec) - %4 failed")
+		.arg(mNumFiles)
+		.arg(sec, 0, 'f', 1)
+		.arg(sec > 0 ? mNumFiles / sec : 0.0, 0, 'f', 2)
+		.arg(mNumFailed.load()));
+
+	return mNumFailed.load();
+}
+
+QSharedPointer<nmc::DkBatchInfo> BatchRunner::process(const QString& filePath) const {
+
+	QSharedPointer<nmc::DkBatchInfo> info;
+	QSharedPointer<nmc::DkImageContainer> imgC(new nmc::DkImageContainer(filePath));
+
+	if (!imgC->loadImage()) {
+		reportProgress(filePath, false);
+		return info;
+	}
+
+	QString outPath = outputFilePath(filePath);
+	nmc::DkSaveInfo saveInfo(filePath, outPath);
+
+	if (mBatchPlugin)
+		imgC = mBatchPlugin->runPlugin(mRunID, imgC, saveInfo, info);
+	else
+		imgC = mPlugin->runPlugin(mRunID, imgC);
+
+	bool ok = imgC && !imgC->image().isNull();
+
+	if (ok && mSaveImages) {
+
+		// never overwrite the inputs (e.g. if the output directory is the input directory)
+		if (QFileInfo(outPath).canonicalFilePath() == QFileInfo(filePath).canonicalFilePath()) {
+			print("refusing to overwrite " + filePath + " - choose a different output directory");
+			ok = false;
+		}
+		else
+			ok = imgC->saveImage(outPath);
+	}
+
+	reportProgress(filePath, ok);
+
+	return info;
+}
+
+QString BatchRunner::outputFilePath(const QString& filePath) const {
+
+	if (mOutputDir.isEmpty())
+		return filePath;
+
+	return QFileInfo(QDir(mOutputDir), QFileInfo(filePath).fileName()).absoluteFilePath();
+}
+
+void BatchRunner::loadSettings() {
+
+	if (!mBatchPlugin)
+		return;
+
+	QString sp = mSettingsFilePath.isEmpty() ? mBatchPlugin->settingsFilePath() : mSettingsFilePath;
+
+	if (sp.isEmpty())
+		return;
+
+	// this is what nomacs does when a batch profile is loaded
+	QSettings s(sp, QSettings::IniFormat);
+	mBatchPlugin->loadSettings(s);
+}
+
+void BatchRunner::reportProgress(const QString & filePath, bool ok) const {
+
+	if (!ok) {
+		mNumFailed.ref();
+		print("could not process " + filePath);
+	}
+
+	int n = mNumProcessed.fetchAndAddOrdered(1) + 1;
+	int step = qMax(mNumFiles / 100, 1);
+
+	if (n % step == 0 || n == mNumFiles) {
+		double sec = mTimer.elapsed() / 1000.0;
+		print(QString("[%1/%2] %3 pages/sec")
+			.arg(n)
+			.arg(mNumFiles)
+			.arg(sec > 0 ? n / sec : 0.0, 0, 'f', 2));
+	}
+}
+
+void BatchRunner::print(const QString & msg) const {
+
+	// qInfo is silenced by some plugins - so we write to stdout
+	QMutexLocker l(&mOutMutex);
+	std::cout << msg.toStdString() << std::endl;
+}
+
+/**
+* Expands the inputs to a list of image files.
+* An input can either be an image, a directory or a text file
+* (prefixed with @) that lists one image per line.
+**/
+QStringList BatchRunner::collectFiles(const QStringList& inputs, bool recursive) {
+
+	QStringList filters;
+	for (const QByteArray& f : QImageReader::supportedImageFormats())
+		filters << "*." + QString::fromLatin1(f);
+
+	QStringList files;
+
+	for (const QString& in : inputs) {
+
+		if (in.startsWith("@")) {
+
+			QFile f(in.mid(1));
+			if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+				qWarning() << "could not open file list" << f.fileName();
+				continue;
+			}
+
+			QTextStream ts(&f);
+			while (!ts.atEnd()) {
+				QString l = ts.readLine().trimmed();
+				if (!l.isEmpty())
+					files << l;
+			}
+		}
+		else if (QFileInfo(in).isDir()) {
+
+			QDirIterator it(in, filters, QDir::Files,
+				recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+
+			QStringList dFiles;
+			while (it.hasNext())
+				dFiles << it.next();
+
+			dFiles.sort();
+			files << dFiles;
+		}
+		else
+			files << in;
+	}
+
+	return files;
+}
+
+QString BatchRunner::listPlugins(const QString& pluginDir) {
+
+	QString msg;
+	QDir dir(pluginDir);
+
+	for (const QString& fn : dir.entryList(QDir::Files)) {
+
+		QString fp = dir.absoluteFilePath(fn);
+		if (!QLibrary::isLibrary(fp))
+			continue;
+
+		QPluginLoader loader(fp);
+		nmc::DkPluginInterface* p = qobject_cast<nmc::DkPluginInterface*>(loader.instance());
+
+		if (!p)
+			continue;
+
+		QJsonObject md = loader.metaData().value("MetaData").toObject();
+		msg += md.value("PluginName").toString() + " (" + QFileInfo(fp).baseName() + ")\n";
+
+		QList<QAction*> actions = p->createActions(0);
+		for (int idx = 0; idx < actions.size(); idx++) {
+			msg += QString("  %1: %2 [%3]\n")
+				.arg(idx)
+				.arg(actions[idx]->text().remove("&"))
+				.arg(actions[idx]->data().toString());
+		}
+	}
+
+	return msg;
+}
+
+QString BatchRunner::normalizeName(const QString& name) {
+
+	QString n = name.toLower();
+	n.remove("&");
+
+	if (n.startsWith("lib"))
+		n = n.mid(3);
+
+	return n.trimmed();
+}
+
+};
@@ -0,0 +1,103 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#include "DkPluginInterface.h"
+#include "DkBatchInfo.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QStringList>
+#pragma warning(pop)		// no warnings from includes - end
+
+class QPluginLoader;
+
+namespace rdm {
+
+/// <summary>
+/// Runs a nomacs (batch) plugin without the nomacs GUI.
+/// The plugin is loaded from the plugin directory and runPlugin()
+/// is called for every file on a pool of worker threads.
+/// postLoadPlugin() is called once with all DkBatchInfo results.
+/// </summary>
+class BatchRunner {
+
+public:
+	BatchRunner();
+	~BatchRunner();
+
+	bool loadPlugin(const QString& pluginDir, const QString& pluginName);
+	bool setRun(const QString& run);
+
+	void setNumThreads(int numThreads);
+	int numThreads() const;
+
+	void setOutputDirectory(const QString& dir);
+	void setSaveImages(bool save);
+	void setSettingsFilePath(const QString& filePath);
+
+	int run(const QStringList& filePaths);
+
+	static QStringList collectFiles(const QStringList& inputs, bool recursive = false);
+	static QString listPlugins(const QString& pluginDir);
+
+protected:
+	QPluginLoader* mLoader = 0;
+	nmc::DkPluginInterface* mPlugin = 0;
+	nmc::DkBatchPluginInterface* mBatchPlugin = 0;
+
+	QString mRunID;
+	QString mOutputDir;
+	QString mSettingsFilePath;
+	bool mSaveImages = false;
+	int mNumThreads = 1;
+
+	// progress
+	int mNumFiles = 0;
+	mutable QAtomicInt mNumProcessed;
+	mutable QAtomicInt mNumFailed;
+	mutable QMutex mOutMutex;
+	QElapsedTimer mTimer;
+
+	QSharedPointer<nmc::DkBatchInfo> process(const QString& filePath) const;
+	QString outputFilePath(const QString& filePath) const;
+	void loadSettings();
+	void reportProgress(const QString& filePath, bool ok) const;
+	void print(const QString& msg) const;
+
+	static QString normalizeName(const QString& name);
+};
+
+};
@@ -0,0 +1,123 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "BatchRunner.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+
+#include <iostream>
+#pragma warning(pop)		// no warnings from includes - end
+
+int main(int argc, char** argv) {
+
+	// we never show a window - so we don't need an X server
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QApplication app(argc, argv);
+
+	// use the same settings as nomacs
+	QCoreApplication::setOrganizationName("nomacs");
+	QCoreApplication::setOrganizationDomain("https://nomacs.org");
+	QCoreApplication::setApplicationName("Image Lounge");
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Runs READ modules on a set of images without the nomacs GUI.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("inputs", "Images, directories or @file-lists to be processed.", "[inputs...]");
+
+	QCommandLineOption pluginOpt(QStringList() << "p" << "plugin", "Plugin name, PluginId or library name.", "plugin");
+	QCommandLineOption runOpt(QStringList() << "r" << "run", "Run ID, menu name or index of the plugin's action.", "run");
+	QCommandLineOption threadOpt(QStringList() << "t" << "threads", "Number of worker threads (default: all cores).", "threads");
+	QCommandLineOption outOpt(QStringList() << "o" << "output", "Output directory (default: results are written next to the inputs).", "dir");
+	QCommandLineOption pluginDirOpt("plugin-dir", "Directory containing the plugins.", "dir",
+		QDir(QCoreApplication::applicationDirPath()).absoluteFilePath("plugins"));
+	QCommandLineOption settingsOpt("settings", "Settings file that is passed to the plugin (batch profile).", "ini");
+	QCommandLineOption saveOpt("save-images", "Save the plugin's output images (requires -o).");
+	QCommandLineOption recursiveOpt("recursive", "Search input directories recursively.");
+	QCommandLineOption listOpt("list", "List all plugins and their actions.");
+
+	parser.addOption(pluginOpt);
+	parser.addOption(runOpt);
+	parser.addOption(threadOpt);
+	parser.addOption(outOpt);
+	parser.addOption(pluginDirOpt);
+	parser.addOption(settingsOpt);
+	parser.addOption(saveOpt);
+	parser.addOption(recursiveOpt);
+	parser.addOption(listOpt);
+	parser.process(app);
+
+	QString pluginDir = parser.value(pluginDirOpt);
+
+	if (parser.isSet(listOpt)) {
+		std::cout << rdm::BatchRunner::listPlugins(pluginDir).toStdString();
+		return 0;
+	}
+
+	if (!parser.isSet(pluginOpt) || !parser.isSet(runOpt) || parser.positionalArguments().isEmpty()) {
+		parser.showHelp(1);
+	}
+
+	// without an output directory the plugin's output would replace the original scans
+	if (parser.isSet(saveOpt) && !parser.isSet(outOpt)) {
+		std::cout << "--save-images requires an output directory (-o)" << std::endl;
+		return 1;
+	}
+
+	rdm::BatchRunner runner;
+
+	if (!runner.loadPlugin(pluginDir, parser.value(pluginOpt)))
+		return 1;
+
+	if (!runner.setRun(parser.value(runOpt)))
+		return 1;
+
+	if (parser.isSet(threadOpt))
+		runner.setNumThreads(parser.value(threadOpt).toInt());
+
+	runner.setOutputDirectory(parser.value(outOpt));
+	runner.setSettingsFilePath(parser.value(settingsOpt));
+	runner.setSaveImages(parser.isSet(saveOpt));
+
+	QStringList files = rdm::BatchRunner::collectFiles(parser.positionalArguments(), parser.isSet(recursiveOpt));
+
+	if (files.isEmpty()) {
+		std::cout << "no images found" << std::endl;
+		return 1;
+	}
+
+	return runner.run(files) == 0 ? 0 : 1;
+}
@@ -0,0 +1,363 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "Benchmark.h"
+
+// ReadFramework
+#include "Elements.h"
+#include "Shapes.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFont>
+#include <QImage>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QTextStream>
+#include <QThread>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include <algorithm>
+#include <random>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef RDM_REVISION
+#define RDM_REVISION "unknown"
+#endif
+
+namespace rdm {
+
+// BenchImage --------------------------------------------------------------------
+QString BenchImage::label() const {
+
+	QString l = name;
+	if (dpi > 0)
+		l += " @" + QString::number(dpi) + " dpi";
+	else
+		l += " x" + QString::number(scale);
+
+	return l;
+}
+
+// BenchResult --------------------------------------------------------------------
+double BenchResult::min() const {
+	return times.empty() ? 0.0 : *std::min_element(times.begin(), times.end());
+}
+
+double BenchResult::median() const {
+
+	if (times.empty())
+		return 0.0;
+
+	QVector<double> t = times;
+	std::nth_element(t.begin(), t.begin() + t.size() / 2, t.end());
+	return t[t.size() / 2];
+}
+
+double BenchResult::mean() const {
+
+	double s = 0.0;
+	for (double t : times)
+		s += t;
+
+	return times.empty() ? 0.0 : s / times.size();
+}
+
+double BenchResult::max() const {
+	return times.empty() ? 0.0 : *std::max_element(times.begin(), times.end());
+}
+
+QJsonObject BenchResult::toJson() const {
+
+	QJsonObject jo;
+	jo["bench"] = bench;
+	jo["image"] = image;
+	jo["dpi"] = dpi;
+	jo["scale"] = scale;
+	jo["width"] = size.width;
+	jo["height"] = size.height;
+	jo["iterations"] = times.size();
+	jo["min_ms"] = min();
+	jo["median_ms"] = median();
+	jo["mean_ms"] = mean();
+	jo["max_ms"] = max();
+	jo["revision"] = Benchmark::revision();
+	jo["threads"] = QThread::idealThreadCount();
+
+	return jo;
+}
+
+// Benchmark --------------------------------------------------------------------
+void Benchmark::addCase(const QString& name, const Case& bench) {
+	mCases << qMakePair(name, bench);
+}
+
+void Benchmark::addImage(const BenchImage& img) {
+	mImages << img;
+}
+
+void Benchmark::setIterations(int iterations) {
+	mIterations = qMax(iterations, 1);
+}
+
+void Benchmark::setFilter(const QString& pattern) {
+	mFilter = QRegularExpression(pattern);
+}
+
+QStringList Benchmark::caseNames() const {
+
+	QStringList names;
+	for (auto c : mCases)
+		names << c.first;
+
+	return names;
+}
+
+/**
+* Runs all cases that match the filter on all images.
+* @param out the JSON lines are written to this stream
+* @return the number of runs
+**/
+int Benchmark::run(QTextStream& out) const {
+
+	int numRuns = 0;
+
+	for (auto c : mCases) {
+
+		if (!mFilter.pattern().isEmpty() && !mFilter.match(c.first).hasMatch())
+			continue;
+
+		for (const BenchImage& img : mImages) {
+
+			BenchResult r = run(c.first, c.second, img);
+
+			if (r.times.empty())
+				continue;
+
+			out << QJsonDocument(r.toJson()).toJson(QJsonDocument::Compact) << "\n";
+			out.flush();
+
+			qInfo().noquote() << c.first << "on" << img.label() << QString::number(r.median(), 'f', 2) << "ms (median)";
+			numRuns++;
+		}
+	}
+
+	return numRuns;
+}
+
+BenchResult Benchmark::run(const QString& name, const Case& bench, const BenchImage& img) const {
+
+	BenchResult r;
+	r.bench = name;
+	r.image = img.name;
+	r.dpi = img.dpi;
+	r.scale = img.scale;
+	r.size = img.img.size();
+
+	Body body = bench(img);
+
+	// the case cannot run on this image (or is not configured)
+	if (!body)
+		return r;
+
+	// warm up (caches, lazy initialization)
+	body();
+
+	for (int idx = 0; idx < mIterations; idx++) {
+
+		QElapsedTimer dt;
+		dt.start();
+		body();
+		r.times << dt.nsecsElapsed() / 1e6;
+	}
+
+	return r;
+}
+
+/// <summary>
+/// Returns the git revision the benchmark was configured with.
+/// </summary>
+QString Benchmark::revision() {
+	return RDM_REVISION;
+}
+
+// SyntheticPage --------------------------------------------------------------------
+/**
+* Renders an A4 page with two columns of random words.
+* The words, the layout and the noise only depend on the seed.
+* @param dpi the page's resolution
+* @param skewDeg the page is rotated by this angle
+* @param seed random seed
+* @return the (grayscale) page and its text regions
+**/
+BenchImage SyntheticPage::create(int dpi, double skewDeg, unsigned int seed) {
+
+	static const char* syllables[] = {
+		"an", "ber", "con", "da", "en", "fol", "ge", "hin", "in", "ker",
+		"lo", "man", "ne", "or", "pri", "que", "rum", "sta", "ti", "un",
+		"ver", "wel", "xa", "zu"
+	};
+	const int numSyllables = sizeof(syllables) / sizeof(syllables[0]);
+
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> syl(0, numSyllables - 1);
+	std::uniform_int_distribution<int> wordLength(1, 4);
+	std::uniform_int_distribution<int> paragraphLength(4, 12);
+
+	QSize size(qRound(8.27 * dpi), qRound(11.69 * dpi));
+	QImage qImg(size, QImage::Format_RGB32);
+	qImg.fill(QColor(236, 232, 220));	// paper
+
+	QFont font("Times");
+	font.setPixelSize(qRound(11.0 / 72.0 * dpi));	// 11 pt
+
+	QPainter p(&qImg);
+	p.setRenderHint(QPainter::Antialiasing);
+	p.setRenderHint(QPainter::TextAntialiasing);
+	p.setFont(font);
+	p.setPen(QColor(40, 30, 25));
+
+	QTransform t;
+	t.translate(size.width() / 2.0, size.height() / 2.0);
+	t.rotate(skewDeg);
+	t.translate(-size.width() / 2.0, -size.height() / 2.0);
+	p.setTransform(t);
+
+	QSharedPointer<rdf::PageElement> page(new rdf::PageElement());
+	page->setImageSize(size);
+	page->setRootRegion(QSharedPointer<rdf::RootRegion>(new rdf::RootRegion()));
+
+	int margin = dpi;
+	int gap = dpi / 3;
+	int lineHeight = qRound(font.pixelSize() * 1.4);
+	int colWidth = (size.width() - 2 * margin - gap) / 2;
+	QFontMetrics fm(font);
+
+	for (int col = 0; col < 2; col++) {
+
+		int x = margin + col * (colWidth + gap);
+		int y = margin;
+
+		while (y + lineHeight < size.height() - margin) {
+
+			QSharedPointer<rdf::TextRegion> tr(new rdf::TextRegion());
+			QRectF trRect(x, y, colWidth, 0);
+			int numLines = paragraphLength(rng);
+
+			for (int lIdx = 0; lIdx < numLines && y + lineHeight < size.height() - margin; lIdx++) {
+
+				QString line;
+				while (true) {
+
+					QString word;
+					int wl = wordLength(rng);
+					for (int sIdx = 0; sIdx < wl; sIdx++)
+						word += syllables[syl(rng)];
+
+					if (fm.width(line + " " + word) > colWidth)
+						break;
+
+					line += line.isEmpty() ? word : " " + word;
+				}
+
+				p.drawText(x, y + fm.ascent(), line);
+
+				QRectF lr(x, y, fm.width(line), lineHeight);
+				QSharedPointer<rdf::TextLine> tl(new rdf::TextLine());
+				tl->setPolygon(rdf::Polygon(t.map(QPolygonF(lr))));
+				tl->setText(line);
+				tr->addChild(tl);
+
+				trRect.setBottom(y + lineHeight);
+				y += lineHeight;
+			}
+
+			tr->setPolygon(rdf::Polygon(t.map(QPolygonF(trRect))));
+			page->rootRegion()->addChild(tr);
+
+			y += lineHeight;	// paragraph gap
+		}
+	}
+
+	p.end();
+
+	// gray + sensor noise
+	QImage gImg = qImg.convertToFormat(QImage::Format_Grayscale8);
+	cv::Mat img(gImg.height(), gImg.width(), CV_8UC1, (void*)gImg.constBits(), gImg.bytesPerLine());
+	img = img.clone();
+
+	cv::Mat noise(img.size(), CV_16SC1);
+	cv::RNG cvRng(seed);
+	cvRng.fill(noise, cv::RNG::NORMAL, 0, 6);
+	cv::Mat img16;
+	img.convertTo(img16, CV_16SC1);
+	img16 += noise;
+	img16.convertTo(img, CV_8UC1);	// saturates
+
+	BenchImage bi;
+	bi.name = "synthetic";
+	bi.dpi = dpi;
+	bi.img = img;
+	bi.page = page;
+
+	return bi;
+}
+
+/**
+* Loads an image from disk.
+* @param filePath the image
+* @param scale the image is resized by this factor
+* @return the image (no regions)
+**/
+BenchImage SyntheticPage::load(const QString& filePath, double scale) {
+
+	BenchImage bi;
+	bi.name = QFileInfo(filePath).fileName();
+	bi.scale = scale;
+	bi.img = cv::imread(filePath.toStdString(), cv::IMREAD_GRAYSCALE);
+
+	if (bi.img.empty()) {
+		qWarning() << "could not load" << filePath;
+		return bi;
+	}
+
+	if (scale != 1.0)
+		cv::resize(bi.img, bi.img, cv::Size(), scale, scale, cv::INTER_AREA);
+
+	return bi;
+}
+
+};
@@ -0,0 +1,134 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QRegularExpression>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QVector>
+#include <opencv2/core/core.hpp>
+
+#include <functional>
+#pragma warning(pop)		// no warnings from includes - end
+
+class QJsonObject;
+class QTextStream;
+
+namespace rdf {
+	class PageElement;
+}
+
+namespace rdm {
+
+/// <summary>
+/// An input of the benchmark - either a synthetic page
+/// or an image from disk at a given scale.
+/// </summary>
+class BenchImage {
+
+public:
+	QString name;
+	int dpi = 0;			// 0 if unknown
+	double scale = 1.0;
+	cv::Mat img;
+	QSharedPointer<rdf::PageElement> page;	// text regions & lines (synthetic pages only)
+
+	QString label() const;
+};
+
+/// <summary>
+/// The timings of a benchmark case on a single image.
+/// </summary>
+class BenchResult {
+
+public:
+	QString bench;
+	QString image;
+	int dpi = 0;
+	double scale = 1.0;
+	cv::Size size;
+	QVector<double> times;	// ms
+
+	double min() const;
+	double median() const;
+	double mean() const;
+	double max() const;
+
+	QJsonObject toJson() const;
+};
+
+/// <summary>
+/// Runs each benchmark case on each image and writes one JSON line per run:
+/// {"bench":"IP::threshOtsu","image":"synthetic","dpi":300,...,"median_ms":12.3}
+/// A case prepares its input (untimed) and returns the function that is timed.
+/// </summary>
+class Benchmark {
+
+public:
+	typedef std::function<void()> Body;
+	typedef std::function<Body(const BenchImage&)> Case;
+
+	void addCase(const QString& name, const Case& bench);
+	void addImage(const BenchImage& img);
+
+	void setIterations(int iterations);
+	void setFilter(const QString& pattern);
+
+	QStringList caseNames() const;
+
+	int run(QTextStream& out) const;
+
+	static QString revision();
+
+private:
+	QVector<QPair<QString, Case> > mCases;
+	QVector<BenchImage> mImages;
+
+	int mIterations = 5;
+	QRegularExpression mFilter;
+
+	BenchResult run(const QString& name, const Case& bench, const BenchImage& img) const;
+};
+
+/// <summary>
+/// Renders reproducible A4 pages with two columns of text.
+/// </summary>
+class SyntheticPage {
+
+public:
+	static BenchImage create(int dpi, double skewDeg = 1.5, unsigned int seed = 42);
+	static BenchImage load(const QString& filePath, double scale = 1.0);
+};
+
+};
@@ -0,0 +1,564 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "Benchmark.h"
+
+// ReadFramework
+#include "Algorithms.h"
+#include "Binarization.h"
+#include "ImageProcessor.h"
+#include "SkewEstimation.h"
+#include "SuperPixel.h"
+#include "SuperPixelScaleSpace.h"
+#include "SuperPixelClassification.h"
+#include "WriterRetrieval.h"
+#include "PageParser.h"
+#include "Elements.h"
+
+#ifdef WITH_TESSERACT
+#include "TesseractEngine.h"
+#include "ImageBridge.h"
+#endif
+
+// ReadModules
+#include "Threshold.h"
+#include "LocalBinarization.h"
+#include "PyramidSkewEstimation.h"
+#include "Rotation.h"
+#include "SkewPreprocessing.h"
+#include "TiledBinarization.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <algorithm>
+#include <iostream>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace {
+
+QVector<double> toNumbers(const QString& list) {
+
+	QVector<double> numbers;
+	for (const QString& s : list.split(",", QString::SkipEmptyParts)) {
+		bool ok = false;
+		double n = s.trimmed().toDouble(&ok);
+		if (ok)
+			numbers << n;
+	}
+
+	return numbers;
+}
+
+/// <summary>
+/// Binarizes the image with and without tiles and writes the fraction of differing pixels:
+/// {"check":"TiledBinarization","image":"synthetic@300dpi","tile_size":1024,"overlap":64,"mismatch":0.001,...}
+/// Pixels within 16 px of a tile border are counted as seam, all others as interior.
+/// </summary>
+/// <returns>false if more than maxMismatch of the interior pixels differ</returns>
+bool compareTiling(const rdm::BenchImage& bi, int tileSize, double maxMismatch, QTextStream& out) {
+
+	rdf::BinarizationSuAdapted bin(bi.img);
+	bin.compute();
+	cv::Mat ref = bin.binaryImage();
+
+	rdm::TiledBinarization tb(bi.img);
+	tb.setTileSize(tileSize);
+	tb.compute();
+	cv::Mat diff = ref != tb.binaryImage();
+
+	const int seamWidth = 16;
+	cv::Mat seam(diff.size(), CV_8UC1, cv::Scalar(0));
+
+	for (int x = tileSize; x < seam.cols; x += tileSize)
+		seam.colRange(qMax(x - seamWidth, 0), qMin(x + seamWidth, seam.cols)).setTo(255);
+	for (int y = tileSize; y < seam.rows; y += tileSize)
+		seam.rowRange(qMax(y - seamWidth, 0), qMin(y + seamWidth, seam.rows)).setTo(255);
+
+	cv::Mat interior = seam == 0;
+	int numSeam = cv::countNonZero(seam);
+	int numInterior = cv::countNonZero(interior);
+
+	QJsonObject jo;
+	jo["check"] = "TiledBinarization";
+	jo["image"] = bi.label();
+	jo["tile_size"] = tileSize;
+	jo["overlap"] = tb.overlap();
+	jo["stroke_width"] = rdm::TiledBinarization::strokeWidth(bi.img);
+	jo["mismatch"] = (double)cv::countNonZero(diff) / diff.total();
+	jo["seam_mismatch"] = numSeam > 0 ? (double)cv::countNonZero(diff & seam) / numSeam : 0.0;
+	double interiorMismatch = numInterior > 0 ? (double)cv::countNonZero(diff & interior) / numInterior : 0.0;
+	bool passed = interiorMismatch <= maxMismatch;
+
+	jo["interior_mismatch"] = interiorMismatch;
+	jo["passed"] = passed;
+
+	out << QJsonDocument(jo).toJson(QJsonDocument::Compact) << "\n";
+
+	return passed;
+}
+
+/// <summary>
+/// The skew ground truth (deg) of DISEC images, e.g. IMG(0006)_SA[-5.76].png.
+/// </summary>
+bool skewGt(const QString& fileName, double& gt) {
+
+	static const QRegularExpression re("\\[([+-]?[0-9]*\\.?[0-9]+)\\]");
+	QRegularExpressionMatch m = re.match(fileName);
+
+	if (!m.hasMatch())
+		return false;
+
+	gt = m.captured(1).toDouble();
+	return true;
+}
+
+/// <summary>
+/// The DISEC measures of the absolute errors (deg) of an estimator:
+/// {"check":"SkewAccuracy","estimator":"pyramid","images":200,"aed":0.08,"top80":0.05,"ce":0.81}
+/// aed: mean error, top80: mean of the 80% best, ce: fraction within 0.1 deg
+/// </summary>
+QJsonObject skewAccuracy(const QString& estimator, QVector<double> errors) {
+
+	std::sort(errors.begin(), errors.end());
+
+	double sum = 0, sumTop = 0;
+	int numCorrect = 0;
+	int numTop = qMax(qRound(errors.size() * 0.8), errors.isEmpty() ? 0 : 1);
+
+	for (int idx = 0; idx < errors.size(); idx++) {
+		sum += errors[idx];
+		if (idx < numTop)
+			sumTop += errors[idx];
+		if (errors[idx] <= 0.1)
+			numCorrect++;
+	}
+
+	QJsonObject jo;
+	jo["check"] = "SkewAccuracy";
+	jo["estimator"] = estimator;
+	jo["images"] = errors.size();
+	jo["aed"] = errors.isEmpty() ? 0.0 : sum / errors.size();
+	jo["top80"] = numTop > 0 ? sumTop / numTop : 0.0;
+	jo["ce"] = errors.isEmpty() ? 0.0 : (double)numCorrect / errors.size();
+
+	return jo;
+}
+
+/// <summary>
+/// Runs the pyramid and rdf::BaseSkewEstimation (SkewPlugin's skewDoc) on
+/// labelled pages and writes one JSON line per image and the DISEC measures
+/// per estimator. Angles are in deg, counter-clockwise positive (as SkewInfo).
+/// </summary>
+/// <returns>false if the pyramid's AED exceeds skewDoc's by more than maxAedIncrease</returns>
+bool compareSkew(const QVector<rdm::BenchImage>& images, const QVector<double>& gts, double maxAedIncrease, QTextStream& out) {
+
+	QVector<double> docErrors, pyramidErrors;
+
+	for (int idx = 0; idx < images.size(); idx++) {
+
+		QSharedPointer<rdm::SkewPreprocessing> pre(new rdm::SkewPreprocessing(images[idx].img));
+		pre->compute();
+
+		rdf::BaseSkewEstimation bse;
+		bse.setImages(pre->gray());
+		bse.setFixedThr(false);
+		bse.compute();
+		double doc = bse.getAngle();
+
+		rdm::PyramidSkewEstimation pse;
+		pse.setPreprocessing(pre);
+		pse.compute();
+		double pyramid = -pse.angle() / CV_PI * 180.0;
+
+		docErrors << qAbs(doc - gts[idx]);
+		pyramidErrors << qAbs(pyramid - gts[idx]);
+
+		QJsonObject jo;
+		jo["check"] = "SkewAccuracy";
+		jo["image"] = images[idx].label();
+		jo["gt"] = gts[idx];
+		jo["doc"] = doc;
+		jo["pyramid"] = pyramid;
+		out << QJsonDocument(jo).toJson(QJsonDocument::Compact) << "\n";
+	}
+
+	QJsonObject docAcc = skewAccuracy("doc", docErrors);
+	QJsonObject pyramidAcc = skewAccuracy("pyramid", pyramidErrors);
+	bool passed = pyramidAcc["aed"].toDouble() <= docAcc["aed"].toDouble() + maxAedIncrease;
+	pyramidAcc["passed"] = passed;
+
+	out << QJsonDocument(docAcc).toJson(QJsonDocument::Compact) << "\n";
+	out << QJsonDocument(pyramidAcc).toJson(QJsonDocument::Compact) << "\n";
+
+	return passed;
+}
+
+void addCases(rdm::Benchmark& bench, const QString& classifierPath, const QString& vocabularyPath, const QString& tessdataDir, QTemporaryDir& tmpDir) {
+
+	using namespace rdm;
+
+	bench.addCase("IP::threshOtsu", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() { rdf::IP::threshOtsu(img); };
+	});
+
+	// the SIMD kernels with each instruction set the CPU supports
+	for (int isa = rdm::Threshold::isa_scalar; isa <= rdm::Threshold::isa(); isa++) {
+
+		QString isaName = rdm::Threshold::isaName((rdm::Threshold::Isa)isa);
+
+		bench.addCase("Threshold::otsu/" + isaName, [isa](const BenchImage& bi) -> Benchmark::Body {
+			cv::Mat img = bi.img;
+			return [img, isa]() {
+				rdm::Threshold::setMaxIsa((rdm::Threshold::Isa)isa);
+				rdm::Threshold::otsu(img);
+				rdm::Threshold::setMaxIsa(rdm::Threshold::isa_avx2);
+			};
+		});
+	}
+
+	bench.addCase("BinarizationSuAdapted::compute", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdf::BinarizationSuAdapted bin(img);
+			bin.compute();
+		};
+	});
+
+	for (int m = rdm::LocalBinarization::method_sauvola; m < rdm::LocalBinarization::method_end; m++) {
+
+		rdm::LocalBinarization::Method method = (rdm::LocalBinarization::Method)m;
+
+		bench.addCase("LocalBinarization::compute/" + rdm::LocalBinarization(cv::Mat(), cv::Mat(), method).name(), [method](const BenchImage& bi) -> Benchmark::Body {
+			cv::Mat img = bi.img;
+			return [img, method]() {
+				rdm::LocalBinarization bin(img, cv::Mat(), method);
+				bin.compute();
+			};
+		});
+	}
+
+	bench.addCase("BaseSkewEstimation::compute", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdf::BaseSkewEstimation bse;
+			bse.setImages(img);
+			bse.setFixedThr(false);
+			bse.compute();
+		};
+	});
+
+	bench.addCase("PyramidSkewEstimation::compute", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdm::PyramidSkewEstimation pse(img);
+			pse.compute();
+		};
+	});
+
+	bench.addCase("IP::rotateImage", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdf::IP::rotateImage(img, 2.0 * CV_PI / 180.0);
+		};
+	});
+
+	for (double deg : { 2.0, 10.0 }) {
+
+		bench.addCase(QString("Rotation::rotate/%1deg").arg(deg), [deg](const BenchImage& bi) -> Benchmark::Body {
+			cv::Mat img = bi.img;
+			return [img, deg]() {
+				rdm::Rotation(deg * CV_PI / 180.0).rotate(img);
+			};
+		});
+	}
+
+	// the opt-in shear path
+	bench.addCase("Rotation::rotate/shear/2deg", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdm::Rotation r(2.0 * CV_PI / 180.0);
+			r.setShearMaxAngle(5.0 * CV_PI / 180.0);
+			r.rotate(img);
+		};
+	});
+
+	bench.addCase("TextLineSkew::compute", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdf::TextLineSkew tls(img);
+			tls.compute();
+		};
+	});
+
+	bench.addCase("ScaleSpaceSuperPixel::compute", [](const BenchImage& bi) -> Benchmark::Body {
+		cv::Mat img = bi.img;
+		return [img]() {
+			rdf::ScaleSpaceSuperPixel<rdf::SuperPixel> sp(img);
+			sp.compute();
+		};
+	});
+
+	if (!classifierPath.isEmpty()) {
+
+		QSharedPointer<rdf::SuperPixelModel> model = rdf::SuperPixelModel::read(classifierPath);
+
+		bench.addCase("SuperPixelClassifier::compute", [model](const BenchImage& bi) -> Benchmark::Body {
+
+			if (!model || !model->model() || !model->model()->isTrained())
+				return Benchmark::Body();
+
+			// the super pixels are not timed
+			QSharedPointer<rdf::ScaleSpaceSuperPixel<rdf::SuperPixel> > sp(new rdf::ScaleSpaceSuperPixel<rdf::SuperPixel>(bi.img));
+			sp->compute();
+
+			cv::Mat img = bi.img;
+			return [img, sp, model]() {
+				rdf::SuperPixelClassifier spc(img, sp->pixelSet());
+				spc.setModel(model);
+				spc.compute();
+			};
+		});
+	}
+
+#ifdef WITH_TESSERACT
+	if (!tessdataDir.isEmpty()) {
+
+		bench.addCase("TesseractEngine::processTextRegions", [tessdataDir](const BenchImage& bi) -> Benchmark::Body {
+
+			if (!bi.page)
+				return Benchmark::Body();
+
+			QSharedPointer<TesseractEngine> engine(new TesseractEngine());
+			if (!engine->init(tessdataDir))
+				return Benchmark::Body();
+
+			QVector<QSharedPointer<rdf::Region> > regions = TesseractEngine::extractTextRegions(bi.page);
+			QImage img = ImageBridge::toQImage(bi.img.clone());
+
+			return [engine, img, regions]() { engine->processTextRegions(img, regions); };
+		});
+	}
+#else
+	Q_UNUSED(tessdataDir);
+#endif
+
+	if (!vocabularyPath.isEmpty()) {
+
+		QSharedPointer<rdf::WriterVocabulary> voc(new rdf::WriterVocabulary());
+		voc->loadVocabulary(vocabularyPath);
+
+		bench.addCase("WriterVocabulary::generateHist", [voc](const BenchImage& bi) -> Benchmark::Body {
+
+			// features are not timed
+			rdf::WriterImage wi;
+			wi.setImage(bi.img);
+			wi.calculateFeatures();
+			cv::Mat desc = wi.descriptors();
+
+			if (desc.empty())
+				return Benchmark::Body();
+
+			return [voc, desc]() { voc->generateHist(desc); };
+		});
+	}
+
+	QString xmlPath = tmpDir.filePath("bench.xml");
+
+	bench.addCase("PageXmlParser::write", [xmlPath](const BenchImage& bi) -> Benchmark::Body {
+
+		if (!bi.page)
+			return Benchmark::Body();
+
+		QSharedPointer<rdf::PageElement> page = bi.page;
+		return [xmlPath, page]() {
+			rdf::PageXmlParser parser;
+			parser.write(xmlPath, page);
+		};
+	});
+
+	bench.addCase("PageXmlParser::read", [xmlPath](const BenchImage& bi) -> Benchmark::Body {
+
+		if (!bi.page)
+			return Benchmark::Body();
+
+		rdf::PageXmlParser writer;
+		writer.write(xmlPath, bi.page);
+
+		return [xmlPath]() {
+			rdf::PageXmlParser parser;
+			parser.read(xmlPath);
+		};
+	});
+}
+
+}
+
+int main(int argc, char** argv) {
+
+	// fonts are needed for the synthetic pages - but no window
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+
+	QGuiApplication app(argc, argv);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Benchmarks the hot functions of the READ modules. Results are written as JSON lines.");
+	parser.addHelpOption();
+	parser.addPositionalArgument("images", "Additional document images.", "[images...]");
+
+	QCommandLineOption dpiOpt("dpi", "Resolutions of the synthetic pages.", "list", "150,300");
+	QCommandLineOption scaleOpt("scales", "Scales of the additional images.", "list", "1.0,0.5");
+	QCommandLineOption iterOpt(QStringList() << "n" << "iterations", "Timed iterations per case (after one warm up run).", "n", "5");
+	QCommandLineOption filterOpt(QStringList() << "f" << "filter", "Only run cases that match this regular expression.", "regexp");
+	QCommandLineOption outOpt(QStringList() << "o" << "output", "Append the results to this file (default: stdout).", "file");
+	QCommandLineOption classifierOpt("classifier", "Super pixel classifier (enables SuperPixelClassifier).", "file");
+	QCommandLineOption vocOpt("vocabulary", "Writer vocabulary (enables WriterVocabulary).", "file");
+	QCommandLineOption tessOpt("tessdata", "Tessdata directory (enables TesseractEngine).", "dir");
+	QCommandLineOption listOpt("list", "List all cases.");
+	QCommandLineOption tilingOpt("tiling", "Compare tiled and untiled Su binarization for these tile sizes instead of timing the cases.", "list");
+	QCommandLineOption skewOpt("skew", "Compare the skew accuracy of the pyramid and skewDoc on synthetic pages rotated by these angles (deg) and on images with DISEC names (e.g. IMG_SA[-5.76].png) instead of timing the cases.", "list");
+	QCommandLineOption aedOpt("max-aed-increase", "AED (deg) the pyramid may lose against skewDoc in --skew (default: 0.05).", "deg", "0.05");
+	QCommandLineOption mismatchOpt("max-mismatch", "Fraction of tile interior pixels that may differ in --tiling (default: 0 - bit-exact).", "fraction", "0");
+
+	parser.addOption(dpiOpt);
+	parser.addOption(scaleOpt);
+	parser.addOption(iterOpt);
+	parser.addOption(filterOpt);
+	parser.addOption(outOpt);
+	parser.addOption(classifierOpt);
+	parser.addOption(vocOpt);
+	parser.addOption(tessOpt);
+	parser.addOption(listOpt);
+	parser.addOption(tilingOpt);
+	parser.addOption(mismatchOpt);
+	parser.addOption(skewOpt);
+	parser.addOption(aedOpt);
+	parser.process(app);
+
+	QTemporaryDir tmpDir;
+	if (!tmpDir.isValid()) {
+		std::cout << "could not create a temporary directory" << std::endl;
+		return 1;
+	}
+
+	rdm::Benchmark bench;
+	bench.setIterations(parser.value(iterOpt).toInt());
+	bench.setFilter(parser.value(filterOpt));
+
+	addCases(bench, parser.value(classifierOpt), parser.value(vocOpt), parser.value(tessOpt), tmpDir);
+
+	if (parser.isSet(listOpt)) {
+		std::cout << bench.caseNames().join("\n").toStdString() << std::endl;
+		return 0;
+	}
+
+	QVector<rdm::BenchImage> images;
+	for (double dpi : toNumbers(parser.value(dpiOpt)))
+		images << rdm::SyntheticPage::create(qRound(dpi));
+
+	for (const QString& fp : parser.positionalArguments()) {
+		for (double s : toNumbers(parser.value(scaleOpt))) {
+			rdm::BenchImage bi = rdm::SyntheticPage::load(fp, s);
+			if (!bi.img.empty())
+				images << bi;
+		}
+	}
+
+	QFile file;
+	if (parser.isSet(outOpt)) {
+		file.setFileName(parser.value(outOpt));
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+			std::cout << "could not open " << file.fileName().toStdString() << std::endl;
+			return 1;
+		}
+	}
+	else
+		file.open(stdout, QIODevice::WriteOnly);
+
+	QTextStream out(&file);
+
+	// a check - fails if the tile interiors differ from the untiled binarization
+	if (parser.isSet(tilingOpt)) {
+
+		int numFailed = 0;
+		for (double ts : toNumbers(parser.value(tilingOpt))) {
+			for (const rdm::BenchImage& bi : images) {
+				if (!compareTiling(bi, qRound(ts), parser.value(mismatchOpt).toDouble(), out))
+					numFailed++;
+			}
+		}
+
+		return numFailed > 0 ? 1 : 0;
+	}
+
+	// a check - fails if the pyramid is less accurate than skewDoc
+	if (parser.isSet(skewOpt)) {
+
+		QVector<rdm::BenchImage> skewImages;
+		QVector<double> gts;
+
+		// QPainter rotates clockwise - the ground truth is counter-clockwise
+		for (double deg : toNumbers(parser.value(skewOpt))) {
+			for (double dpi : toNumbers(parser.value(dpiOpt))) {
+				rdm::BenchImage bi = rdm::SyntheticPage::create(qRound(dpi), deg);
+				bi.name += QString("[%1]").arg(-deg);
+				skewImages << bi;
+				gts << -deg;
+			}
+		}
+
+		for (const rdm::BenchImage& bi : images) {
+			double gt = 0;
+			if (bi.dpi == 0 && skewGt(bi.name, gt)) {
+				skewImages << bi;
+				gts << gt;
+			}
+		}
+
+		return compareSkew(skewImages, gts, parser.value(aedOpt).toDouble(), out) ? 0 : 1;
+	}
+
+	for (const rdm::BenchImage& bi : images)
+		bench.addImage(bi);
+
+	return bench.run(out) > 0 ? 0 : 1;
+}
@@ -36,9 +36,25 @@ related links:
 #include "ImageProcessor.h"
 #include "Binarization.h"
 #include "DkImageStorage.h"
+#include "Settings.h"
+
+// ReadModules
+#include "ImageBridge.h"
+#include "Telemetry.h"
+#include "TiledBinarization.h"
+#include "Threshold.h"
+#include "BinaryCache.h"
+#include "LocalBinarization.h"
+#include "ProgressiveBinarization.h"
 
 #pragma warning(push, 0)	// no warnings from includes - begin
 #include <QAction>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QThread>
+#include <QCoreApplication>
 #pragma warning(pop)		// no warnings from includes - end
 
 namespace rdm {
@@ -55,6 +71,8 @@ BinarizationPlugin::BinarizationPlugin(QObject* parent) : QObject(parent) {
 	runIds[id_binarize_otsu] = "4398d8e26fe9454384432e690b47d4d3";
 	runIds[id_binarize_su] = "73c1efff27c043d298d8acd99530af1d";
 	runIds[id_binarize_su_mask] = "051d7f9d278a4c7ab3f97822a288c276";
+	runIds[id_binarize_sauvola] = "a1f3c2e07b5d4c0e9d6b8f2a4e7c1d35";
+	runIds[id_binarize_wolf] = "5e9b0d4a2c7f41b8a3e6d1f0c8b2a947";
 	mRunIDs = runIds.toList();
 
 	// create menu actions
@@ -64,6 +82,8 @@ BinarizationPlugin::BinarizationPlugin(QObject* parent) : QObject(parent) {
 	menuNames[id_binarize_otsu] = tr("&Otsu Threshold");
 	menuNames[id_binarize_su] = tr("&Su Binarization");
 	menuNames[id_binarize_su_mask] = tr("&Su Binarization with Mask Estimation");
+	menuNames[id_binarize_sauvola] = tr("S&auvola Binarization");
+	menuNames[id_binarize_wolf] = tr("&Wolf Binarization");
 	mMenuNames = menuNames.toList();
 
 	// create menu status tips
@@ -73,10 +93,20 @@ BinarizationPlugin::BinarizationPlugin(QObject* parent) : QObject(parent) {
 	statusTips[id_binarize_otsu] = tr("Thresholds a document with the famous Otsu method");
 	statusTips[id_binarize_su] = tr("Thresholds a document with the Su method");
 	statusTips[id_binarize_su_mask] = tr("Thresholds a document with the Su method and estimates the mask");
+	statusTips[id_binarize_sauvola] = tr("Fast local thresholding with the Sauvola method");
+	statusTips[id_binarize_wolf] = tr("Fast local thresholding with the Wolf method (normalized with the page's contrast)");
 	mMenuStatusTips = statusTips.toList();
 
 	// TODO: switch to new format with loadSettings()
 	mBBSConfig.loadSettings();
+
+	rdf::DefaultSettings s;
+	s.beginGroup("BinarizationPlugin");
+	mConfig.saveDefaultSettings(s);
+	mConfig.loadSettings(s);
+	s.endGroup();
+
+	mProgressive = QSharedPointer<ProgressiveBinarization>(new ProgressiveBinarization());
 }
 /**
 *	Destructor
@@ -85,6 +115,9 @@ BinarizationPlugin::~BinarizationPlugin() {
 
 	//qDebug() << "destroying binarization plugin...";
 	//mBBSConfig.saveSettings();
+
+	// wait for background refinements
+	mProgressive.clear();
 }
 
 /**
@@ -106,6 +139,10 @@ QList<QAction*> BinarizationPlugin::createActions(QWidget* parent) {
 			ca->setStatusTip(mMenuStatusTips[idx]);
 			ca->setData(mRunIDs[idx]);	// runID needed for calling function runPlugin()
 			mActions.append(ca);
+
+			// batches (e.g. read-batch) create the actions without a parent to resolve run IDs
+			if (parent)
+				connect(ca, SIGNAL(triggered()), this, SLOT(onActionTriggered()));
 		}
 	}
 
@@ -116,6 +153,13 @@ QList<QAction*> BinarizationPlugin::pluginActions() const {
 	return mActions;
 }
 
+/// <summary>
+/// The next runPlugin() call was requested by the user - so it may show a preview.
+/// </summary>
+void BinarizationPlugin::onActionTriggered() {
+	mInteractive = true;
+}
+
 /**
 * Main function: runs plugin based on its ID
 * @param plugin ID
@@ -126,55 +170,277 @@ QSharedPointer<nmc::DkImageContainer> BinarizationPlugin::runPlugin(const QStrin
 	if (!imgC)
 		return imgC;
 
+	TelemetryPage tp(imgC->filePath());
+	ScopedSpan span("binarization");
+
+	// previews are only shown if the user triggered the action
+	bool interactive = mInteractive.exchange(false);
+
+	// a new interactive run supersedes the background refinement (the user
+	// changed the image or applies another method - its result is outdated)
+	if (interactive && mProgressive)
+		mProgressive->cancel();
+
+	// the binary images are kept as 8 bit grayscale (no conversion needed)
 	if(runID == mRunIDs[id_binarize_otsu]) {
 	
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
-		imgCv = rdf::IP::threshOtsu(imgCv);
-		QImage img = nmc::DkImage::mat2QImage(imgCv);
-		img = img.convertToFormat(QImage::Format_ARGB32);
-		imgC->setImage(img, tr("Otsu Binarization"));
+		// vectorized equivalent of rdf::IP::threshOtsu
+		MatView imgCv(imgC->image());
+		cv::Mat bImg = Threshold::otsu(imgCv);
+		span.addBytes(bImg);
+		setResult(mConfig, imgC, bImg, tr("Otsu Binarization"));
 	}
 	else if(runID == mRunIDs[id_binarize_su]) {
 		
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
-		
-		rdf::BinarizationSuAdapted segSuM(imgCv);
-
-		//set settings
-		//QSharedPointer<rdf::BaseBinarizationSuConfig> cf = segSuM.config();
-		//*cf = mBBSConfig;
+		MatView imgCv(imgC->image());
 
-		segSuM.compute();
-		imgCv = segSuM.binaryImage();
-
-		QImage img = nmc::DkImage::mat2QImage(imgCv);
-		img = img.convertToFormat(QImage::Format_ARGB32);
+		if (!interactive || !binarizeProgressive(imgC, imgCv, cv::Mat(), tr("Su Binarization"))) {
+			cv::Mat bImg = binarizeSu(mConfig, imgCv);
+			span.addBytes(bImg);
 
-		imgC->setImage(img, tr("Su Binarization"));
+			setResult(mConfig, imgC, bImg, tr("Su Binarization"));
+		}
 	}
 	else if (runID == mRunIDs[id_binarize_su_mask]) {
 	
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
-		cv::Mat mask = rdf::IP::estimateMask(imgCv);
-		
-		rdf::BinarizationSuAdapted segSuM(imgCv, mask);
+		MatView imgCv(imgC->image());
+		cv::Mat mask = BinaryCache::instance().get(imgCv, BinaryCache::mask(), [&]() { return rdf::IP::estimateMask(imgCv); });
+
+		if (!interactive || !binarizeProgressive(imgC, imgCv, mask, tr("Su Binarization"))) {
+			cv::Mat bImg = binarizeSu(mConfig, imgCv, mask);
+			span.addBytes(bImg);
+
+			setResult(mConfig, imgC, bImg, tr("Su Binarization"));
+		}
+	}
+	else if (runID == mRunIDs[id_binarize_sauvola] || runID == mRunIDs[id_binarize_wolf]) {
+
+		bool wolf = runID == mRunIDs[id_binarize_wolf];
+
+		MatView imgCv(imgC->image());
+		LocalBinarization lb(imgCv, cv::Mat(), wolf ? LocalBinarization::method_wolf : LocalBinarization::method_sauvola);
+		lb.setWindowSize(mConfig.localWindowSize());
+		lb.setK(wolf ? mConfig.wolfK() : mConfig.sauvolaK());
+		lb.compute();
+
+		cv::Mat bImg = lb.binaryImage();
+		span.addBytes(bImg);
+
+		setResult(mConfig, imgC, bImg, tr("%1 Binarization").arg(lb.name()));
+	}
+
+	// wrong runID? - do nothing
+	return imgC;
+};
+
+cv::Mat BinarizationPlugin::binarizeSu(const BinarizationConfig& config, const cv::Mat& img, const cv::Mat& mask, const std::atomic<bool>* cancel) {
+
+	// large scans (newspapers, maps) are binarized in parallel tiles
+	if (config.useTiles(img.size())) {
+
+		QString cacheConfig = BinaryCache::su(!mask.empty()) + QString("/tiles:%1,%2").arg(config.tileSize()).arg(config.tileOverlap());
+
+		return BinaryCache::instance().get(img, cacheConfig, [&]() {
+			TiledBinarization tb(img, mask);
+			tb.setTileSize(config.tileSize());
+			tb.setOverlap(config.tileOverlap());
+			tb.setCancel(cancel);
+			tb.compute();
+
+			return tb.binaryImage();
+		});
+	}
+
+	return BinaryCache::instance().get(img, BinaryCache::su(!mask.empty()), [&]() -> cv::Mat {
+
+		if (cancel && *cancel)
+			return cv::Mat();
+
+		rdf::BinarizationSuAdapted segSuM(img, mask);
 
 		//set settings
 		//QSharedPointer<rdf::BaseBinarizationSuConfig> cf = segSuM.config();
 		//*cf = mBBSConfig;
 
+		// NOTE: rdf cannot be interrupted - the flag is checked before & after
 		segSuM.compute();
-		imgCv = segSuM.binaryImage();
 
-		QImage img = nmc::DkImage::mat2QImage(imgCv);
-		img = img.convertToFormat(QImage::Format_ARGB32);
+		// empty results are not cached
+		if (cancel && *cancel)
+			return cv::Mat();
+
+		return segSuM.binaryImage();
+	});
+}
+
+/// <summary>
+/// Shows a low resolution Su binarization of large images and
+/// computes the full resolution result in the background.
+/// Only used if the user triggered the action (batch processing needs the final result).
+/// </summary>
+/// <returns>false if the image should be binarized at once</returns>
+bool BinarizationPlugin::binarizeProgressive(QSharedPointer<nmc::DkImageContainer> imgC, const MatView& img, const cv::Mat& mask, const QString& editName) const {
+
+	if (!mProgressive || !mConfig.useProgressive(img.mat().size()))
+		return false;
+
+	// the refinement is delivered through the GUI thread's event loop
+	if (!QCoreApplication::instance() || QThread::currentThread() != QCoreApplication::instance()->thread())
+		return false;
+
+	cv::Mat pImg = ProgressiveBinarization::preview(img, mask, mConfig.previewScale(), [](const cv::Mat& sImg, const cv::Mat& sMask) {
+		rdf::BinarizationSuAdapted bin(sImg, sMask);
+		bin.compute();
+		return bin.binaryImage();
+	});
+
+	setResult(mConfig, imgC, pImg, editName + " " + tr("(preview)"));
+
+	// the MatView keeps a reference on the original pixels
+	// the config is copied - the plugin might be unloaded before the refinement is done
+	MatView fImg = img;
+	cv::Mat fMask = mask;
+	BinarizationConfig config = mConfig;
+
+	mProgressive->refine(imgC, [config, fImg, fMask](const std::atomic<bool>& cancel) {
+		return binarizeSu(config, fImg, fMask, &cancel);
+	}, [config, editName](QSharedPointer<nmc::DkImageContainer> fImgC, const cv::Mat& bwImg) {
+		setResult(config, fImgC, bwImg, editName);
+	});
+
+	return true;
+}
+
+void BinarizationPlugin::setResult(const BinarizationConfig& config, QSharedPointer<nmc::DkImageContainer> imgC, const cv::Mat& bwImg, const QString& editName) {
+
+	QImage mono;
+	if (config.monoOutput() || config.saveTiff())
+		mono = ImageBridge::toMono(bwImg);
 
-		imgC->setImage(img, tr("Su Binarization"));
+	if (config.saveTiff())
+		saveTiff(mono, imgC->filePath());
+
+	imgC->setImage(config.monoOutput() ? mono : ImageBridge::toQImage(bwImg), editName);
+}
+
+bool BinarizationPlugin::saveTiff(const QImage& img, const QString& imgPath) {
+
+	QFileInfo fi(imgPath);
+	QDir dir(fi.absolutePath());
+
+	if (!dir.mkpath("bin")) {
+		qWarning() << "[Binarization] cannot create" << dir.absoluteFilePath("bin");
+		return false;
 	}
 
-	// wrong runID? - do nothing
-	return imgC;
-};
+	// NOTE: Qt's TIFF writer compresses 1 bit images with LZW (CCITT G4 needs libtiff directly)
+	QImageWriter writer(dir.absoluteFilePath("bin/" + fi.completeBaseName() + ".tif"), "tiff");
+	writer.setCompression(1);
+
+	if (!writer.write(img)) {
+		qWarning() << "[Binarization] cannot write" << writer.fileName() << writer.errorString();
+		return false;
+	}
+
+	return true;
+}
+
+// BinarizationConfig --------------------------------------------------------------------
+BinarizationConfig::BinarizationConfig() : ModuleConfig("Binarization") {
+}
+
+QString BinarizationConfig::toString() const {
+
+	QString msg = rdf::ModuleConfig::toString();
+	msg += " tile size: " + QString::number(mTileSize);
+	msg += " overlap: " + QString::number(mTileOverlap);
+	msg += " tiled above: " + QString::number(mTiledMinMegaPixels) + " MP";
+	msg += mMonoOutput ? " 1 bit output" : "";
+	msg += mSaveTiff ? " saving TIFF" : "";
+	msg += " local window: " + QString::number(mLocalWindowSize) + " px";
+	msg += " k (Sauvola/Wolf): " + QString::number(mSauvolaK) + "/" + QString::number(mWolfK);
+	msg += mProgressive ? " preview at " + QString::number(mPreviewScale) + " above " + QString::number(mProgressiveMinMegaPixels) + " MP" : "";
+
+	return msg;
+}
+
+int BinarizationConfig::tileSize() const {
+	return mTileSize;
+}
+
+int BinarizationConfig::tileOverlap() const {
+	return mTileOverlap;
+}
+
+bool BinarizationConfig::useTiles(const cv::Size& size) const {
+
+	if (mTiledMinMegaPixels <= 0 || mTileSize <= 0)
+		return false;
+
+	return (double)size.area() / 1e6 > mTiledMinMegaPixels;
+}
+
+bool BinarizationConfig::monoOutput() const {
+	return mMonoOutput;
+}
+
+bool BinarizationConfig::saveTiff() const {
+	return mSaveTiff;
+}
+
+int BinarizationConfig::localWindowSize() const {
+	return mLocalWindowSize;
+}
+
+double BinarizationConfig::sauvolaK() const {
+	return mSauvolaK;
+}
+
+double BinarizationConfig::wolfK() const {
+	return mWolfK;
+}
+
+bool BinarizationConfig::useProgressive(const cv::Size& size) const {
+
+	if (!mProgressive || mPreviewScale <= 0 || mPreviewScale >= 1)
+		return false;
+
+	return (double)size.area() / 1e6 > mProgressiveMinMegaPixels;
+}
+
+double BinarizationConfig::previewScale() const {
+	return mPreviewScale;
+}
+
+void BinarizationConfig::load(const QSettings & settings) {
+
+	mTileSize			= settings.value("tileSize", mTileSize).toInt();
+	mTileOverlap		= settings.value("tileOverlap", mTileOverlap).toInt();
+	mTiledMinMegaPixels	= settings.value("tiledMinMegaPixels", mTiledMinMegaPixels).toDouble();
+	mMonoOutput			= settings.value("monoOutput", mMonoOutput).toBool();
+	mSaveTiff			= settings.value("saveTiff", mSaveTiff).toBool();
+	mLocalWindowSize	= settings.value("localWindowSize", mLocalWindowSize).toInt();
+	mSauvolaK			= settings.value("sauvolaK", mSauvolaK).toDouble();
+	mWolfK				= settings.value("wolfK", mWolfK).toDouble();
+	mProgressive		= settings.value("progressive", mProgressive).toBool();
+	mPreviewScale		= settings.value("previewScale", mPreviewScale).toDouble();
+	mProgressiveMinMegaPixels = settings.value("progressiveMinMegaPixels", mProgressiveMinMegaPixels).toDouble();
+}
+
+void BinarizationConfig::save(QSettings & settings) const {
+
+	settings.setValue("tileSize", mTileSize);
+	settings.setValue("tileOverlap", mTileOverlap);
+	settings.setValue("tiledMinMegaPixels", mTiledMinMegaPixels);
+	settings.setValue("monoOutput", mMonoOutput);
+	settings.setValue("saveTiff", mSaveTiff);
+	settings.setValue("localWindowSize", mLocalWindowSize);
+	settings.setValue("sauvolaK", mSauvolaK);
+	settings.setValue("wolfK", mWolfK);
+	settings.setValue("progressive", mProgressive);
+	settings.setValue("previewScale", mPreviewScale);
+	settings.setValue("progressiveMinMegaPixels", mProgressiveMinMegaPixels);
+}
 
 };
 
@@ -35,8 +35,52 @@ related links:
 #include "DkPluginInterface.h"
 #include "Binarization.h"
 
+// ReadModules
+#include "ImageBridge.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <atomic>
+#pragma warning(pop)		// no warnings from includes - end
+
 namespace rdm {
 
+class ProgressiveBinarization;
+
+class BinarizationConfig : public rdf::ModuleConfig {
+
+public:
+	BinarizationConfig();
+
+	virtual QString toString() const override;
+
+	int tileSize() const;
+	int tileOverlap() const;
+	bool useTiles(const cv::Size& size) const;
+	bool monoOutput() const;
+	bool saveTiff() const;
+	int localWindowSize() const;
+	double sauvolaK() const;
+	double wolfK() const;
+	bool useProgressive(const cv::Size& size) const;
+	double previewScale() const;
+
+protected:
+	int mTileSize = 4096;			// px
+	int mTileOverlap = 0;			// px - 0 derives it from the stroke width
+	double mTiledMinMegaPixels = 0;	// images larger than this are binarized in tiles (0 = never) - not bit-exact
+	bool mMonoOutput = false;		// 1 bit (packed) instead of 8 bit results
+	bool mSaveTiff = false;			// save results as 1 bit TIFF to <image dir>/bin/
+	int mLocalWindowSize = 31;		// px - Sauvola/Wolf window
+	double mSauvolaK = 0.2;
+	double mWolfK = 0.5;
+	bool mProgressive = true;		// show a preview first & refine in the background (GUI only)
+	double mPreviewScale = 0.25;
+	double mProgressiveMinMegaPixels = 8;	// smaller images are binarized at once
+
+	void load(const QSettings& settings) override;
+	void save(QSettings& settings) const override;
+};
+
 class BinarizationPlugin : public QObject, nmc::DkPluginInterface {
 	Q_OBJECT
 	Q_INTERFACES(nmc::DkPluginInterface)
@@ -56,6 +100,8 @@ public:
 		id_binarize_otsu,
 		id_binarize_su,
 		id_binarize_su_mask,
+		id_binarize_sauvola,
+		id_binarize_wolf,
 		// add actions here
 
 		id_end
@@ -68,6 +114,19 @@ protected:
 	QStringList mMenuStatusTips;
 
 	rdf::BaseBinarizationSuConfig mBBSConfig;
+	BinarizationConfig mConfig;
+	QSharedPointer<ProgressiveBinarization> mProgressive;
+	mutable std::atomic<bool> mInteractive{ false };	// set if the user triggered an action (GUI)
+
+	bool binarizeProgressive(QSharedPointer<nmc::DkImageContainer> imgC, const MatView& img, const cv::Mat& mask, const QString& editName) const;
+
+	// static - background refinements must not reference the plugin
+	static cv::Mat binarizeSu(const BinarizationConfig& config, const cv::Mat& img, const cv::Mat& mask = cv::Mat(), const std::atomic<bool>* cancel = 0);
+	static void setResult(const BinarizationConfig& config, QSharedPointer<nmc::DkImageContainer> imgC, const cv::Mat& bwImg, const QString& editName);
+	static bool saveTiff(const QImage& img, const QString& imgPath);
+
+protected slots:
+	void onActionTriggered();
 };
 
 };
@@ -0,0 +1,149 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "ProgressiveBinarization.h"
+
+// nomacs
+#include "DkImageContainer.h"
+
+// ReadModules
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QDebug>
+#include <QtConcurrent>
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+ProgressiveBinarization::ProgressiveBinarization(QObject* parent) : QObject(parent) {
+
+	connect(&mWatcher, SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+ProgressiveBinarization::~ProgressiveBinarization() {
+
+	// superseded refinements might still run - their code lives in the plugin's library
+	cancel();
+	mPool.waitForDone();
+}
+
+/// <summary>
+/// Binarizes img at the given scale (e.g. 0.25) and upscales the result to the original size.
+/// </summary>
+cv::Mat ProgressiveBinarization::preview(const cv::Mat& img, const cv::Mat& mask, double scale, const std::function<cv::Mat(const cv::Mat&, const cv::Mat&)>& binarize) {
+
+	ScopedSpan span("binarization/preview");
+
+	cv::Mat sImg, sMask;
+	cv::resize(img, sImg, cv::Size(), scale, scale, cv::INTER_AREA);
+
+	if (!mask.empty())
+		cv::resize(mask, sMask, sImg.size(), 0, 0, cv::INTER_NEAREST);
+
+	cv::Mat sBw = binarize(sImg, sMask);
+
+	// interpolate & threshold -> smoother strokes than nearest neighbor
+	cv::Mat bw;
+	cv::resize(sBw, bw, img.size(), 0, 0, cv::INTER_LINEAR);
+	cv::threshold(bw, bw, 127, 255, cv::THRESH_BINARY);
+
+	return bw;
+}
+
+/// <summary>
+/// Computes the full resolution result in the background.
+/// finish is called in the GUI thread if the computation was not cancelled
+/// and imgC is still alive. A running refinement is cancelled.
+/// </summary>
+void ProgressiveBinarization::refine(QSharedPointer<nmc::DkImageContainer> imgC, const Compute& compute, const Finish& finish) {
+
+	cancel();
+
+	QSharedPointer<std::atomic<bool> > c(new std::atomic<bool>(false));
+	mCancel = c;
+	mImgC = imgC;
+	mFinish = finish;
+
+	// NOTE: the old future keeps running until it checks its cancel flag - its result is dropped
+	mWatcher.setFuture(QtConcurrent::run(&mPool, [c, compute]() -> cv::Mat {
+
+		cv::Mat bw = compute(*c);
+		return *c ? cv::Mat() : bw;
+	}));
+}
+
+void ProgressiveBinarization::cancel() {
+
+	if (mCancel)
+		*mCancel = true;
+
+	mCancel.clear();
+	mImgC.clear();
+	mFinish = Finish();
+}
+
+bool ProgressiveBinarization::isRunning() const {
+	return mWatcher.isRunning();
+}
+
+void ProgressiveBinarization::onFinished() {
+
+	// cancelled or superseded
+	if (!mCancel || *mCancel)
+		return;
+
+	QSharedPointer<nmc::DkImageContainer> imgC = mImgC.toStrongRef();
+	cv::Mat bw = mWatcher.result();
+	Finish finish = mFinish;
+
+	mCancel.clear();
+	mImgC.clear();
+	mFinish = Finish();
+
+	if (!imgC) {
+		qInfo() << "[Binarization] image released - full resolution result dropped";
+		return;
+	}
+
+	// nomacs unloads images the user navigated away from (if memory caching is off)
+	if (!imgC->hasImage()) {
+		qInfo() << "[Binarization] image unloaded - full resolution result dropped";
+		return;
+	}
+
+	if (!bw.empty() && finish)
+		finish(imgC, bw);
+}
+
+};
@@ -0,0 +1,95 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QObject>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QWeakPointer>
+#include <opencv2/core/core.hpp>
+
+#include <atomic>
+#include <functional>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace nmc {
+	class DkImageContainer;
+}
+
+namespace rdm {
+
+/// <summary>
+/// Progressive binarization for interactive use.
+/// preview() binarizes a downscaled copy which is shown immediately while
+/// refine() computes the full resolution result in the background and
+/// swaps it into the image container once it is done.
+/// A running refinement is cancelled if the user triggers the plugin again
+/// (on this or a different image), if the image container is released
+/// or if the plugin is unloaded. Results for images that nomacs unloaded
+/// are dropped. Refinements run in a private thread pool so that the
+/// destructor can wait for superseded ones too.
+/// NOTE: the plugin interface does not report navigation in the viewer -
+/// if the user moves on and the image stays cached, the refinement keeps
+/// running and its result is set to the (not shown) image.
+/// The compute & finish functions must not reference the plugin.
+/// </summary>
+class ProgressiveBinarization : public QObject {
+	Q_OBJECT
+
+public:
+	typedef std::function<cv::Mat(const std::atomic<bool>& cancel)> Compute;
+	typedef std::function<void(QSharedPointer<nmc::DkImageContainer> imgC, const cv::Mat& bwImg)> Finish;
+
+	ProgressiveBinarization(QObject* parent = 0);
+	~ProgressiveBinarization();
+
+	static cv::Mat preview(const cv::Mat& img, const cv::Mat& mask, double scale, const std::function<cv::Mat(const cv::Mat&, const cv::Mat&)>& binarize);
+
+	void refine(QSharedPointer<nmc::DkImageContainer> imgC, const Compute& compute, const Finish& finish);
+	void cancel();
+	bool isRunning() const;
+
+private slots:
+	void onFinished();
+
+private:
+	QThreadPool mPool;
+	QFutureWatcher<cv::Mat> mWatcher;
+	QSharedPointer<std::atomic<bool> > mCancel;
+	QWeakPointer<nmc::DkImageContainer> mImgC;
+	Finish mFinish;
+};
+
+};
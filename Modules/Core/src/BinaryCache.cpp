@@ -0,0 +1,301 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "BinaryCache.h"
+
+// ReadFramework
+#include "Settings.h"
+
+// ReadModules
+#include "ImageBridge.h"
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+BinaryCache::BinaryCache() {
+
+	mDirPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/binary";
+
+	rdf::DefaultSettings s;
+	s.beginGroup("BinaryCache");
+	mEnabled = s.value("enabled", mEnabled).toBool();
+	mDirPath = s.value("dirPath", mDirPath).toString();
+	mMaxRecentBytes = s.value("memoryMegaBytes", mMaxRecentBytes / (1024 * 1024)).toLongLong() * 1024 * 1024;
+	mMaxDiskBytes = s.value("diskMegaBytes", mMaxDiskBytes / (1024 * 1024)).toLongLong() * 1024 * 1024;
+	s.endGroup();
+}
+
+BinaryCache& BinaryCache::instance() {
+
+	static BinaryCache inst;
+	return inst;
+}
+
+/**
+* Returns the cached binary image of img or computes (and caches) it.
+* @param img the input image
+* @param config identifies the method & parameters (e.g. BinaryCache::su())
+* @param compute computes the binary image if it is not cached
+* @return a CV_8UC1 image (0 and 255) that is not shared with the cache
+**/
+cv::Mat BinaryCache::get(const cv::Mat& img, const QString& config, const std::function<cv::Mat()>& compute) {
+
+	if (!mEnabled)
+		return compute();
+
+	QByteArray k = key(img, config);
+
+	cv::Mat bwImg;
+	if (find(k, bwImg))
+		return bwImg;
+
+	bwImg = compute();
+
+	// e.g. cancelled
+	if (!bwImg.empty())
+		insert(k, bwImg);
+
+	return bwImg;
+}
+
+bool BinaryCache::find(const QByteArray& key, cv::Mat& bwImg) {
+
+	{
+		QMutexLocker l(&mMutex);
+		for (auto it = mRecent.begin(); it != mRecent.end(); it++) {
+			if (it->key == key) {
+				Entry e = *it;
+				mRecent.erase(it);
+				mRecent.prepend(e);
+				bwImg = e.bwImg.clone();	// the caller might modify it
+				return true;
+			}
+		}
+	}
+
+	QString fp = filePath(key);
+	if (!QFileInfo(fp).exists())
+		return false;
+
+	ScopedSpan span("binaryCache/load");
+	QImage img(fp);
+
+	if (!ImageBridge::isBinary(img)) {
+		qWarning() << "[BinaryCache] ignoring invalid sidecar:" << fp;
+		return false;
+	}
+
+	// mark as recently used for the cleanup (older Qt versions remove the oldest sidecars)
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+	QFile f(fp);
+	if (f.open(QIODevice::ReadWrite))
+		f.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+#endif
+
+	bwImg = ImageBridge::fromMono(img);
+	addRecent(key, bwImg);
+
+	return true;
+}
+
+void BinaryCache::insert(const QByteArray& key, const cv::Mat& bwImg) {
+
+	if (bwImg.empty())
+		return;
+
+	addRecent(key, bwImg);
+
+	ScopedSpan span("binaryCache/save");
+
+	if (!QDir().mkpath(mDirPath)) {
+		qWarning() << "[BinaryCache] cannot create" << mDirPath;
+		return;
+	}
+
+	// write & rename - other processes might read the sidecar meanwhile
+	QString fp = filePath(key);
+	QString tmpPath = fp + ".tmp";
+
+	if (!ImageBridge::toMono(bwImg).save(tmpPath, "png")) {
+		qWarning() << "[BinaryCache] cannot write" << tmpPath;
+		return;
+	}
+
+	QFile::remove(fp);
+	QFile::rename(tmpPath, fp);
+
+	addDiskBytes(QFileInfo(fp).size());
+}
+
+/// <summary>
+/// Hashes the image's gray values (and size) together with the config.
+/// Color images are hashed as gray images since all binarizations work on gray values -
+/// so the key does not depend on how a module converted the QImage.
+/// </summary>
+QByteArray BinaryCache::key(const cv::Mat& img, const QString& config) {
+
+	cv::Mat gImg = img;
+	if (img.channels() == 4)
+		cv::cvtColor(img, gImg, cv::COLOR_BGRA2GRAY);
+	else if (img.channels() == 3)
+		cv::cvtColor(img, gImg, cv::COLOR_BGR2GRAY);
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(config.toUtf8());
+
+	int header[3] = { gImg.rows, gImg.cols, gImg.type() };
+	hash.addData(reinterpret_cast<const char*>(header), sizeof(header));
+
+	int rowBytes = (int)(gImg.cols * gImg.elemSize());
+	for (int r = 0; r < gImg.rows; r++)
+		hash.addData(reinterpret_cast<const char*>(gImg.ptr(r)), rowBytes);
+
+	return hash.result();
+}
+
+QString BinaryCache::su(bool withMask) {
+	return withMask ? "BinarizationSuAdapted+mask" : "BinarizationSuAdapted";
+}
+
+QString BinaryCache::mask() {
+	return "estimateMask";
+}
+
+bool BinaryCache::isEnabled() const {
+	return mEnabled;
+}
+
+QString BinaryCache::dirPath() const {
+	return mDirPath;
+}
+
+QString BinaryCache::filePath(const QByteArray& key) const {
+	return QDir(mDirPath).absoluteFilePath(QString::fromLatin1(key.toHex()) + ".png");
+}
+
+/// <summary>
+/// Keeps a copy of bwImg in memory and drops the least recently used
+/// images if they exceed the memory budget.
+/// </summary>
+void BinaryCache::addRecent(const QByteArray& key, const cv::Mat& bwImg) {
+
+	// images larger than the budget are not kept
+	qint64 bytes = (qint64)(bwImg.total() * bwImg.elemSize());
+	if (bytes > mMaxRecentBytes)
+		return;
+
+	// clone - the caller owns (and might modify) bwImg
+	QMutexLocker l(&mMutex);
+	mRecent.prepend(Entry{ key, bwImg.clone() });
+	mRecentBytes += bytes;
+
+	while (mRecentBytes > mMaxRecentBytes && !mRecent.isEmpty()) {
+		const cv::Mat& last = mRecent.last().bwImg;
+		mRecentBytes -= (qint64)(last.total() * last.elemSize());
+		mRecent.removeLast();
+	}
+}
+
+/// <summary>
+/// Counts a new sidecar and cleans up the directory if it exceeds the disk budget.
+/// The directory is scanned once - sidecars of other processes are only
+/// noticed when the directory is cleaned up.
+/// </summary>
+void BinaryCache::addDiskBytes(qint64 bytes) {
+
+	{
+		QMutexLocker l(&mMutex);
+
+		if (mDiskBytes >= 0) {
+			mDiskBytes += bytes;
+
+			if (mDiskBytes <= mMaxDiskBytes)
+				return;
+		}
+	}
+
+	cleanup();
+}
+
+/// <summary>
+/// Removes the least recently used sidecars until 90% of the disk budget are used.
+/// </summary>
+void BinaryCache::cleanup() {
+
+	QFileInfoList files = QDir(mDirPath).entryInfoList(QStringList() << "*.png", QDir::Files);
+
+	qint64 bytes = 0;
+	for (const QFileInfo& fi : files)
+		bytes += fi.size();
+
+	if (bytes > mMaxDiskBytes) {
+
+		ScopedSpan span("binaryCache/cleanup");
+
+		std::sort(files.begin(), files.end(), [](const QFileInfo& a, const QFileInfo& b) {
+			return a.lastModified() < b.lastModified();
+		});
+
+		int numRemoved = 0;
+		for (const QFileInfo& fi : files) {
+
+			if (bytes <= mMaxDiskBytes * 9 / 10)
+				break;
+
+			if (QFile::remove(fi.absoluteFilePath())) {
+				bytes -= fi.size();
+				numRemoved++;
+			}
+		}
+
+		qInfo() << "[BinaryCache] removed" << numRemoved << "sidecars from" << mDirPath;
+	}
+
+	QMutexLocker l(&mMutex);
+	mDiskBytes = bytes;
+}
+
+};
@@ -0,0 +1,110 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QByteArray>
+#include <QLinkedList>
+#include <QMutex>
+#include <QString>
+#include <opencv2/core/core.hpp>
+
+#include <functional>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Process-wide cache of binary images (binarization results and masks).
+/// Results are keyed by a hash of the input pixels and a config string
+/// (e.g. BinaryCache::su()) and stored as 1 bit PNG sidecars so that
+/// modules (and later runs) do not binarize the same page again.
+/// The last results are additionally kept in memory (BinaryCache/memoryMegaBytes).
+/// If the sidecars exceed BinaryCache/diskMegaBytes, the least recently
+/// used ones are removed (hits refresh a sidecar's modification time).
+/// Callers get their own copy of the binary image.
+/// The cache is disabled by default (BinaryCache/enabled).
+/// </summary>
+class DllRdmExport BinaryCache {
+
+public:
+	static BinaryCache& instance();
+
+	cv::Mat get(const cv::Mat& img, const QString& config, const std::function<cv::Mat()>& compute);
+
+	bool find(const QByteArray& key, cv::Mat& bwImg);
+	void insert(const QByteArray& key, const cv::Mat& bwImg);
+
+	static QByteArray key(const cv::Mat& img, const QString& config);
+
+	// configs shared by all modules
+	static QString su(bool withMask = false);
+	static QString mask();
+
+	bool isEnabled() const;
+	QString dirPath() const;
+
+private:
+	BinaryCache();
+	BinaryCache(const BinaryCache&);
+
+	struct Entry {
+		QByteArray key;
+		cv::Mat bwImg;
+	};
+
+	mutable QMutex mMutex;
+	QLinkedList<Entry> mRecent;		// most recently used first
+	qint64 mRecentBytes = 0;
+	qint64 mDiskBytes = -1;			// -1 until the directory was scanned
+
+	bool mEnabled = false;
+	QString mDirPath;
+	qint64 mMaxRecentBytes = 256 * 1024 * 1024;
+	qint64 mMaxDiskBytes = 2048ll * 1024 * 1024;
+
+	QString filePath(const QByteArray& key) const;
+	void addRecent(const QByteArray& key, const cv::Mat& bwImg);
+	void addDiskBytes(qint64 bytes);
+	void cleanup();
+};
+
+};
@@ -0,0 +1,265 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "ImageBridge.h"
+
+// ReadFramework
+#include "Image.h"
+
+// ReadModules
+#include "Threshold.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+namespace {
+	thread_local int gNumCopies = 0;
+}
+
+// MatView --------------------------------------------------------------------
+MatView::MatView(const QImage& img) {
+
+	if (img.isNull())
+		return;
+
+	switch (img.format()) {
+
+	case QImage::Format_Grayscale8:
+		mImg = img;
+		mMat = cv::Mat(mImg.height(), mImg.width(), CV_8UC1, (void*)mImg.constBits(), mImg.bytesPerLine());
+		break;
+	case QImage::Format_RGB32:
+	case QImage::Format_ARGB32:
+	case QImage::Format_ARGB32_Premultiplied:
+		mImg = img;
+		mMat = cv::Mat(mImg.height(), mImg.width(), CV_8UC4, (void*)mImg.constBits(), mImg.bytesPerLine());
+		break;
+	case QImage::Format_Mono:
+	case QImage::Format_MonoLSB:
+		// 1 bit images are unpacked to 0 and 255
+		mMat = ImageBridge::fromMono(img);
+		ImageBridge::countCopy();
+		return;
+	default:
+		// indexed & 16 bit images are expanded (that's a copy)
+		mImg = img.isGrayscale() ? img.convertToFormat(QImage::Format_Grayscale8) : img.convertToFormat(QImage::Format_ARGB32);
+		ImageBridge::countCopy();
+		mMat = cv::Mat(mImg.height(), mImg.width(), mImg.format() == QImage::Format_Grayscale8 ? CV_8UC1 : CV_8UC4,
+			(void*)mImg.constBits(), mImg.bytesPerLine());
+		return;
+	}
+
+	mShared = true;
+}
+
+const cv::Mat& MatView::mat() const {
+	return mMat;
+}
+
+MatView::operator const cv::Mat&() const {
+	return mMat;
+}
+
+bool MatView::isEmpty() const {
+	return mMat.empty();
+}
+
+/// <summary>
+/// Returns true if the view points to the pixels of the original QImage.
+/// </summary>
+bool MatView::isShared() const {
+	return mShared;
+}
+
+// ImageBridge --------------------------------------------------------------------
+MatView ImageBridge::toMat(const QImage& img) {
+	return MatView(img);
+}
+
+/**
+* Creates a QImage that shares the buffer of mat.
+* CV_8UC1 maps to Format_Grayscale8 and CV_8UC4 to Format_ARGB32.
+* All other types are converted (and counted as copy).
+* @param mat an OpenCV image
+* @return a QImage that keeps a reference on the mat's pixels
+**/
+QImage ImageBridge::toQImage(const cv::Mat& mat) {
+
+	if (mat.empty())
+		return QImage();
+
+	cv::Mat m = mat;
+
+	if (m.type() == CV_8UC3) {
+		cv::cvtColor(m, m, CV_BGR2BGRA);
+		countCopy();
+	}
+	else if (m.type() != CV_8UC1 && m.type() != CV_8UC4) {
+		countCopy();
+		return rdf::Image::mat2QImage(m);
+	}
+	else if (!m.u) {
+		// the mat does not own its pixels (e.g. a MatView) - we cannot share them
+		m = m.clone();
+		countCopy();
+	}
+
+	return QImage(m.data, m.cols, m.rows, (int)m.step, qFormat(m), &ImageBridge::releaseMat, new cv::Mat(m));
+}
+
+/// <summary>
+/// Packs a binary image (pixels > 127 are set) into a 1 bit QImage.
+/// Set pixels are white - a 100 MP page needs 12.5 MB instead of 100 MB (gray) or 400 MB (ARGB).
+/// </summary>
+QImage ImageBridge::toMono(const cv::Mat& bwImg) {
+
+	if (bwImg.empty())
+		return QImage();
+
+	cv::Mat packed = Threshold::thresholdPacked(bwImg, 127, false);
+
+	QImage img(bwImg.cols, bwImg.rows, QImage::Format_Mono);
+	img.setColorTable(QVector<QRgb>() << qRgb(0, 0, 0) << qRgb(255, 255, 255));
+
+	for (int r = 0; r < packed.rows; r++)
+		memcpy(img.scanLine(r), packed.ptr<uchar>(r), packed.cols);
+
+	return img;
+}
+
+/// <summary>
+/// Unpacks a 1 bit image to CV_8UC1 - the gray values are taken from the color table.
+/// </summary>
+cv::Mat ImageBridge::fromMono(const QImage& img) {
+
+	if (img.isNull())
+		return cv::Mat();
+
+	QImage mImg = img.format() == QImage::Format_Mono ? img : img.convertToFormat(QImage::Format_Mono);
+
+	uchar v[2] = { 0, 255 };
+	if (mImg.colorCount() == 2) {
+		v[0] = (uchar)qGray(mImg.color(0));
+		v[1] = (uchar)qGray(mImg.color(1));
+	}
+
+	// 8 output pixels per input byte
+	static const QVector<quint64> masks = []() {
+		QVector<quint64> m(256);
+		for (int b = 0; b < 256; b++) {
+			quint64 w = 0;
+			for (int bi = 0; bi < 8; bi++) {
+				if (b & (0x80 >> bi))
+					w |= quint64(0xff) << (bi * 8);
+			}
+			m[b] = w;
+		}
+		return m;
+	}();
+
+	quint64 w0 = quint64(0x0101010101010101ULL) * v[0];
+	quint64 w1 = quint64(0x0101010101010101ULL) * v[1];
+
+	cv::Mat m(mImg.height(), mImg.width(), CV_8UC1);
+	int fullBytes = m.cols / 8;
+
+	for (int r = 0; r < m.rows; r++) {
+
+		const uchar* src = mImg.constScanLine(r);
+		uchar* dst = m.ptr<uchar>(r);
+
+		for (int c = 0; c < fullBytes; c++) {
+			quint64 mask = masks[src[c]];
+			quint64 w = (w1 & mask) | (w0 & ~mask);
+			memcpy(dst + c * 8, &w, 8);	// little endian: first pixel in the lowest byte
+		}
+
+		for (int c = fullBytes * 8; c < m.cols; c++)
+			dst[c] = v[(src[c / 8] >> (7 - c % 8)) & 1];
+	}
+
+	return m;
+}
+
+/// <summary>
+/// Returns a binary CV_8UC1 image of a 1 bit image where text (the minority) is white -
+/// like rdf::BinarizationSuAdapted's results.
+/// </summary>
+cv::Mat ImageBridge::toBinary(const QImage& img) {
+
+	cv::Mat bw = fromMono(img);
+
+	if (!bw.empty() && (size_t)cv::countNonZero(bw) > bw.total() / 2)
+		cv::bitwise_not(bw, bw);
+
+	return bw;
+}
+
+/// <summary>
+/// Returns true if the image is a 1 bit image (e.g. a packed binarization result).
+/// </summary>
+bool ImageBridge::isBinary(const QImage& img) {
+	return img.format() == QImage::Format_Mono || img.format() == QImage::Format_MonoLSB;
+}
+
+/// <summary>
+/// Returns the QImage format that shares the layout of mat or Format_Invalid.
+/// </summary>
+QImage::Format ImageBridge::qFormat(const cv::Mat& mat) {
+
+	switch (mat.type()) {
+	case CV_8UC1:	return QImage::Format_Grayscale8;
+	case CV_8UC4:	return QImage::Format_ARGB32;
+	}
+
+	return QImage::Format_Invalid;
+}
+
+/// <summary>
+/// Returns the number of pixel copies the calling thread made so far.
+/// </summary>
+int ImageBridge::numCopies() {
+	return gNumCopies;
+}
+
+void ImageBridge::countCopy() {
+	gNumCopies++;
+}
+
+void ImageBridge::releaseMat(void* mat) {
+	delete static_cast<cv::Mat*>(mat);
+}
+
+};
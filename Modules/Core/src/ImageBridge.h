@@ -0,0 +1,103 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QImage>
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Read-only cv::Mat header on the pixels of a QImage.
+/// The view holds a (shallow) copy of the QImage so that
+/// the pixels stay valid as long as the view exists.
+/// Pixels are only copied if OpenCV cannot interpret the
+/// QImage's format (e.g. indexed color images). 1 bit images
+/// are unpacked to CV_8UC1 (0 and 255).
+/// NOTE: never write into mat() - it shares the image's pixels.
+/// </summary>
+class DllRdmExport MatView {
+
+public:
+	MatView(const QImage& img = QImage());
+
+	const cv::Mat& mat() const;
+	operator const cv::Mat&() const;
+
+	bool isEmpty() const;
+	bool isShared() const;
+
+private:
+	QImage mImg;
+	cv::Mat mMat;
+	bool mShared = false;
+};
+
+/// <summary>
+/// Converts between QImage and cv::Mat without copying pixels.
+/// QImages created by toQImage() share the cv::Mat's buffer and keep
+/// a reference on it. Each conversion that has to copy pixels
+/// is counted (per thread) which allows for measuring how many
+/// deep copies a plugin makes per page.
+/// </summary>
+class DllRdmExport ImageBridge {
+
+public:
+	static MatView toMat(const QImage& img);
+	static QImage toQImage(const cv::Mat& mat);
+
+	static QImage toMono(const cv::Mat& bwImg);
+	static cv::Mat fromMono(const QImage& img);
+	static cv::Mat toBinary(const QImage& img);
+	static bool isBinary(const QImage& img);
+
+	static QImage::Format qFormat(const cv::Mat& mat);
+
+	static int numCopies();
+	static void countCopy();
+
+private:
+	static void releaseMat(void* mat);
+};
+
+};
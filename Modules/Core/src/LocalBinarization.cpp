@@ -0,0 +1,246 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "LocalBinarization.h"
+
+// ReadModules
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QDebug>
+#include <QMutex>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cmath>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+LocalBinarization::LocalBinarization(const cv::Mat& img, const cv::Mat& mask, Method method) {
+	mImg = img;
+	mMask = mask;
+	mMethod = method;
+}
+
+void LocalBinarization::setWindowSize(int windowSize) {
+	mWindowSize = windowSize;
+}
+
+void LocalBinarization::setK(double k) {
+	mK = k;
+}
+
+/// <summary>
+/// Binarizes the image (text = 255).
+/// Sauvola:	T = m * (1 + k * (s / R - 1))
+/// Wolf:		T = (1 - k) * m + k * M + k * s / R * (m - M)
+/// where m, s are the window's mean & std, M is the image's minimum
+/// and R is 128 (Sauvola) or the maximal local std (Wolf).
+/// </summary>
+/// <returns>false if the image is empty</returns>
+bool LocalBinarization::compute() {
+
+	if (mImg.empty())
+		return false;
+
+	ScopedSpan span("binarization/" + name().toLower());
+
+	cv::Mat img = mImg;
+	if (img.channels() == 4)
+		cv::cvtColor(img, img, cv::COLOR_BGRA2GRAY);
+	else if (img.channels() == 3)
+		cv::cvtColor(img, img, cv::COLOR_BGR2GRAY);
+
+	if (img.depth() != CV_8U)
+		img.convertTo(img, CV_8U, 255);
+
+	cv::Mat sum, sqSum;
+	integral(img, sum, sqSum);
+
+	double k = mK < 0 ? defaultK(mMethod) : mK;
+	double r = mR;
+	double minVal = 0;
+
+	// Wolf normalizes with the image's contrast
+	if (mMethod == method_wolf) {
+
+		cv::minMaxLoc(img, &minVal);
+
+		QMutex mutex;
+		double maxStd = 0;
+
+		cv::parallel_for_(cv::Range(0, img.rows), [&](const cv::Range& range) {
+
+			double cMax = 0;
+			for (int rIdx = range.start; rIdx < range.end; rIdx++) {
+				for (int cIdx = 0; cIdx < img.cols; cIdx++) {
+					double m, s;
+					stats(sum, sqSum, rIdx, cIdx, m, s);
+					cMax = qMax(cMax, s);
+				}
+			}
+
+			QMutexLocker l(&mutex);
+			maxStd = qMax(maxStd, cMax);
+		});
+
+		r = qMax(maxStd, 1e-6);
+	}
+
+	mBwImg.create(img.size(), CV_8UC1);
+
+	cv::parallel_for_(cv::Range(0, img.rows), [&](const cv::Range& range) {
+
+		for (int rIdx = range.start; rIdx < range.end; rIdx++) {
+
+			const unsigned char* iPtr = img.ptr<unsigned char>(rIdx);
+			const unsigned char* mPtr = mMask.empty() ? 0 : mMask.ptr<unsigned char>(rIdx);
+			unsigned char* bPtr = mBwImg.ptr<unsigned char>(rIdx);
+
+			for (int cIdx = 0; cIdx < img.cols; cIdx++) {
+
+				double m, s;
+				stats(sum, sqSum, rIdx, cIdx, m, s);
+
+				double t = (mMethod == method_wolf)
+					? (1.0 - k) * m + k * minVal + k * s / r * (m - minVal)
+					: m * (1.0 + k * (s / r - 1.0));
+
+				bPtr[cIdx] = (iPtr[cIdx] <= t && (!mPtr || mPtr[cIdx])) ? 255 : 0;
+			}
+		}
+	});
+
+	span.addBytes(mBwImg);
+
+	return true;
+}
+
+cv::Mat LocalBinarization::binaryImage() const {
+	return mBwImg;
+}
+
+QString LocalBinarization::name() const {
+	return mMethod == method_wolf ? "Wolf" : "Sauvola";
+}
+
+double LocalBinarization::defaultK(Method method) {
+	return method == method_wolf ? 0.5 : 0.2;
+}
+
+/// <summary>
+/// Computes the integral images of img and img^2 (CV_64FC1, (rows+1) x (cols+1)).
+/// Same result as cv::integral(img, sum, sqSum, CV_64F, CV_64F) but rows are
+/// accumulated in parallel first and columns (in strips) second.
+/// </summary>
+void LocalBinarization::integral(const cv::Mat& img, cv::Mat& sum, cv::Mat& sqSum) {
+
+	CV_Assert(img.type() == CV_8UC1);
+
+	sum = cv::Mat::zeros(img.rows + 1, img.cols + 1, CV_64FC1);
+	sqSum = cv::Mat::zeros(img.rows + 1, img.cols + 1, CV_64FC1);
+
+	// prefix sums per row
+	cv::parallel_for_(cv::Range(0, img.rows), [&](const cv::Range& range) {
+
+		for (int rIdx = range.start; rIdx < range.end; rIdx++) {
+
+			const unsigned char* iPtr = img.ptr<unsigned char>(rIdx);
+			double* sPtr = sum.ptr<double>(rIdx + 1);
+			double* qPtr = sqSum.ptr<double>(rIdx + 1);
+
+			double s = 0, q = 0;
+			for (int cIdx = 0; cIdx < img.cols; cIdx++) {
+				double v = iPtr[cIdx];
+				s += v;
+				q += v * v;
+				sPtr[cIdx + 1] = s;
+				qPtr[cIdx + 1] = q;
+			}
+		}
+	});
+
+	// accumulate rows - columns are independent so strips are processed in parallel
+	int stripWidth = 256;
+	int numStrips = (sum.cols + stripWidth - 1) / stripWidth;
+
+	cv::parallel_for_(cv::Range(0, numStrips), [&](const cv::Range& range) {
+
+		for (int sIdx = range.start; sIdx < range.end; sIdx++) {
+
+			int cStart = sIdx * stripWidth;
+			int cEnd = qMin(cStart + stripWidth, sum.cols);
+
+			for (int rIdx = 2; rIdx < sum.rows; rIdx++) {
+
+				const double* spPtr = sum.ptr<double>(rIdx - 1);
+				const double* qpPtr = sqSum.ptr<double>(rIdx - 1);
+				double* sPtr = sum.ptr<double>(rIdx);
+				double* qPtr = sqSum.ptr<double>(rIdx);
+
+				for (int cIdx = cStart; cIdx < cEnd; cIdx++) {
+					sPtr[cIdx] += spPtr[cIdx];
+					qPtr[cIdx] += qpPtr[cIdx];
+				}
+			}
+		}
+	});
+}
+
+/// <summary>
+/// Mean and std of the window centered at (row, col).
+/// Windows are clipped at the image border.
+/// </summary>
+void LocalBinarization::stats(const cv::Mat& sum, const cv::Mat& sqSum, int row, int col, double& mean, double& std) const {
+
+	int hw = mWindowSize / 2;
+
+	int r0 = qMax(row - hw, 0);
+	int c0 = qMax(col - hw, 0);
+	int r1 = qMin(row + hw + 1, sum.rows - 1);
+	int c1 = qMin(col + hw + 1, sum.cols - 1);
+
+	double n = (double)(r1 - r0) * (c1 - c0);
+
+	const double* s0 = sum.ptr<double>(r0);
+	const double* s1 = sum.ptr<double>(r1);
+	const double* q0 = sqSum.ptr<double>(r0);
+	const double* q1 = sqSum.ptr<double>(r1);
+
+	double s = s1[c1] - s1[c0] - s0[c1] + s0[c0];
+	double q = q1[c1] - q1[c0] - q0[c1] + q0[c0];
+
+	mean = s / n;
+	std = std::sqrt(qMax(q / n - mean * mean, 0.0));
+}
+
+};
@@ -0,0 +1,93 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QString>
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Sauvola and Wolf (local mean/std) binarization.
+/// The local statistics are computed from integral images of I and I^2
+/// (double precision, exact for images up to ~10^11 px) so that the cost
+/// per pixel does not depend on the window size. Integral images and
+/// thresholds are computed row-parallel.
+/// Much faster than Su for large windows - a "good enough" path for bulk ingestion.
+/// </summary>
+class DllRdmExport LocalBinarization {
+
+public:
+	enum Method {
+		method_sauvola = 0,
+		method_wolf,
+
+		method_end
+	};
+
+	LocalBinarization(const cv::Mat& img = cv::Mat(), const cv::Mat& mask = cv::Mat(), Method method = method_sauvola);
+
+	void setWindowSize(int windowSize);
+	void setK(double k);
+
+	bool compute();
+	cv::Mat binaryImage() const;
+
+	QString name() const;
+	static double defaultK(Method method);
+	static void integral(const cv::Mat& img, cv::Mat& sum, cv::Mat& sqSum);
+
+private:
+	cv::Mat mImg;
+	cv::Mat mMask;
+	cv::Mat mBwImg;
+
+	Method mMethod = method_sauvola;
+	int mWindowSize = 31;	// px
+	double mK = -1;			// < 0: method's default
+	double mR = 128;		// dynamic range of the std (Sauvola)
+
+	void stats(const cv::Mat& sum, const cv::Mat& sqSum, int row, int col, double& mean, double& std) const;
+};
+
+};
@@ -0,0 +1,254 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "PageXmlCache.h"
+
+// ReadFramework
+#include "PageParser.h"
+#include "Elements.h"
+#include "Settings.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+PageXmlCache::PageXmlCache() {
+
+	rdf::DefaultSettings s;
+	s.beginGroup("PageXmlCache");
+	mMaxBytes = s.value("maxMegaBytes", mMaxBytes / (1024 * 1024)).toLongLong() * 1024 * 1024;
+	s.endGroup();
+}
+
+PageXmlCache& PageXmlCache::instance() {
+
+	static PageXmlCache inst;
+	return inst;
+}
+
+/**
+* Returns the PAGE tree of xmlPath.
+* The XML is only parsed if the cache does not hold a valid entry.
+* By default the tree is removed from the cache since the caller
+* is allowed to modify it - write() puts it back. Callers that
+* do not modify the tree should set readOnly to keep it cached.
+* Modifying callers never get a tree that was handed out read-only,
+* the XML is parsed again instead.
+* @param xmlPath the PAGE XML file
+* @param found is set to true if the XML exists
+* @param readOnly if true, the caller must not modify the tree
+* @return the PAGE tree (an empty page if the XML does not exist)
+**/
+QSharedPointer<rdf::PageElement> PageXmlCache::read(const QString& xmlPath, bool* found, bool readOnly) {
+
+	QFileInfo fi(xmlPath);
+	QString key = fi.canonicalFilePath();
+
+	if (!key.isEmpty()) {
+
+		QSharedPointer<rdf::PageElement> page = take(key, fi, readOnly);
+
+		if (page) {
+			if (found)
+				*found = true;
+			return page;
+		}
+	}
+
+	// parse outside the lock - parsing large pages takes a while
+	rdf::PageXmlParser parser;
+	bool ok = parser.read(xmlPath);
+
+	if (found)
+		*found = ok;
+
+	QSharedPointer<rdf::PageElement> page = parser.page();
+
+	if (ok && readOnly && !key.isEmpty())
+		insert(key, fi, page, true);
+
+	return page;
+}
+
+/**
+* Writes the PAGE tree to xmlPath and caches it.
+* The tree is only cached if the file was written.
+* The caller must not modify the tree after writing it.
+* @param xmlPath the PAGE XML file
+* @param page the PAGE tree
+* @return false if the file could not be written
+**/
+bool PageXmlCache::write(const QString& xmlPath, const QSharedPointer<rdf::PageElement>& page) {
+
+	// coarse file systems (e.g. FAT) store the modification time in 2 sec steps
+	QDateTime started = QDateTime::currentDateTime().addSecs(-2);
+
+	rdf::PageXmlParser parser;
+	parser.write(xmlPath, page);
+
+	// the parser does not report errors - check the file instead
+	QFileInfo fi(xmlPath);
+	QString key = fi.canonicalFilePath();
+	bool ok = fi.exists() && fi.size() > 0 && fi.lastModified() >= started;
+
+	if (!ok) {
+		qWarning() << "[PageXmlCache] could not write" << xmlPath;
+
+		// the file might be partially written
+		if (!key.isEmpty()) {
+			QMutexLocker l(&mMutex);
+			remove(key);
+		}
+
+		return false;
+	}
+
+	if (page)
+		insert(key, fi, page);
+
+	return true;
+}
+
+void PageXmlCache::setMaxBytes(qint64 maxBytes) {
+
+	QMutexLocker l(&mMutex);
+	mMaxBytes = maxBytes;
+	evict();
+}
+
+qint64 PageXmlCache::maxBytes() const {
+	return mMaxBytes;
+}
+
+void PageXmlCache::clear() {
+
+	QMutexLocker l(&mMutex);
+	mEntries.clear();
+	mLru.clear();
+	mBytes = 0;
+}
+
+QString PageXmlCache::toString() const {
+
+	QMutexLocker l(&mMutex);
+
+	QString msg = "PAGE XML cache: ";
+	msg += QString::number(mEntries.size()) + " entries, ";
+	msg += QString::number(mBytes / 1024) + "/" + QString::number(mMaxBytes / 1024) + " KB, ";
+	msg += QString::number(mNumHits) + " hits, " + QString::number(mNumMisses) + " misses";
+
+	return msg;
+}
+
+QSharedPointer<rdf::PageElement> PageXmlCache::take(const QString& key, const QFileInfo& fi, bool readOnly) {
+
+	QMutexLocker l(&mMutex);
+
+	auto it = mEntries.find(key);
+
+	if (it == mEntries.end()) {
+		mNumMisses++;
+		return QSharedPointer<rdf::PageElement>();
+	}
+
+	// someone else changed the file
+	if (it->size != fi.size() || it->modified != fi.lastModified()) {
+		remove(key);
+		mNumMisses++;
+		return QSharedPointer<rdf::PageElement>();
+	}
+
+	// read-only callers might still hold this tree - modifying it would corrupt theirs
+	if (!readOnly && it->shared) {
+		remove(key);
+		mNumMisses++;
+		return QSharedPointer<rdf::PageElement>();
+	}
+
+	QSharedPointer<rdf::PageElement> page = it->page;
+	mNumHits++;
+
+	if (readOnly) {
+		it->shared = true;
+		mLru.removeOne(key);
+		mLru.prepend(key);
+	}
+	else
+		remove(key);
+
+	return page;
+}
+
+void PageXmlCache::insert(const QString& key, const QFileInfo& fi, const QSharedPointer<rdf::PageElement>& page, bool shared) {
+
+	QMutexLocker l(&mMutex);
+
+	remove(key);
+
+	Entry e;
+	e.page = page;
+	e.size = fi.size();
+	e.modified = fi.lastModified();
+	e.shared = shared;
+
+	mEntries.insert(key, e);
+	mLru.prepend(key);
+	mBytes += e.size;
+
+	evict();
+}
+
+void PageXmlCache::remove(const QString& key) {
+
+	auto it = mEntries.find(key);
+
+	if (it == mEntries.end())
+		return;
+
+	mBytes -= it->size;
+	mEntries.erase(it);
+	mLru.removeOne(key);
+}
+
+void PageXmlCache::evict() {
+
+	while (mBytes > mMaxBytes && !mLru.isEmpty()) {
+		QString key = mLru.last();
+		remove(key);
+	}
+}
+
+};
@@ -0,0 +1,109 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QHash>
+#include <QDateTime>
+#include <QLinkedList>
+#include <QMutex>
+#include <QSharedPointer>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+class QFileInfo;
+
+namespace rdf {
+	class PageElement;
+}
+
+namespace rdm {
+
+/// <summary>
+/// Process-wide cache of parsed PAGE XML files.
+/// Entries are keyed by the canonical file path and validated
+/// against the file's size and modification time. If plugins are
+/// chained in a batch, the tree written by one stage (write-through)
+/// is handed to the next stage without parsing the XML again.
+/// The byte budget is approximated by the XML file sizes, least
+/// recently used entries are dropped first.
+/// </summary>
+class DllRdmExport PageXmlCache {
+
+public:
+	static PageXmlCache& instance();
+
+	QSharedPointer<rdf::PageElement> read(const QString& xmlPath, bool* found = 0, bool readOnly = false);
+	bool write(const QString& xmlPath, const QSharedPointer<rdf::PageElement>& page);
+
+	void setMaxBytes(qint64 maxBytes);
+	qint64 maxBytes() const;
+
+	void clear();
+	QString toString() const;
+
+private:
+	PageXmlCache();
+	PageXmlCache(const PageXmlCache&);
+
+	struct Entry {
+		QSharedPointer<rdf::PageElement> page;
+		qint64 size = 0;
+		QDateTime modified;
+		bool shared = false;	// handed out to read-only callers
+	};
+
+	mutable QMutex mMutex;
+	QHash<QString, Entry> mEntries;
+	QLinkedList<QString> mLru;		// most recently used first
+
+	qint64 mBytes = 0;
+	qint64 mMaxBytes = 256 * 1024 * 1024;
+
+	int mNumHits = 0;
+	int mNumMisses = 0;
+
+	QSharedPointer<rdf::PageElement> take(const QString& key, const QFileInfo& fi, bool readOnly);
+	void insert(const QString& key, const QFileInfo& fi, const QSharedPointer<rdf::PageElement>& page, bool shared = false);
+	void remove(const QString& key);
+	void evict();
+};
+
+};
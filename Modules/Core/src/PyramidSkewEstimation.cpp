@@ -0,0 +1,207 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "PyramidSkewEstimation.h"
+
+// ReadModules
+#include "SkewPreprocessing.h"
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <cmath>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+PyramidSkewEstimation::PyramidSkewEstimation(const cv::Mat& img) {
+	mImg = img;
+}
+
+/// <summary>
+/// Sets the search range (rad).
+/// </summary>
+void PyramidSkewEstimation::setRange(double minAngle, double maxAngle) {
+	mMinAngle = minAngle;
+	mMaxAngle = maxAngle;
+}
+
+/// <summary>
+/// Uses a precomputed pyramid (e.g. shared by several estimators).
+/// The coarse size is then defined by the preprocessing.
+/// </summary>
+void PyramidSkewEstimation::setPreprocessing(const QSharedPointer<SkewPreprocessing>& pre) {
+	mPre = pre;
+}
+
+void PyramidSkewEstimation::setCoarseSize(int coarseSize) {
+	mCoarseSize = coarseSize;
+}
+
+/// <summary>
+/// Sets the angular precision (rad) - finer pyramid levels are skipped.
+/// </summary>
+void PyramidSkewEstimation::setPrecision(double precision) {
+	mPrecision = precision;
+}
+
+/// <summary>
+/// Estimates the skew.
+/// </summary>
+/// <returns>false if the image is empty or has no foreground</returns>
+bool PyramidSkewEstimation::compute() {
+
+	if (!mPre) {
+		mPre = QSharedPointer<SkewPreprocessing>(new SkewPreprocessing(mImg, mCoarseSize));
+		mPre->compute();
+	}
+
+	if (mPre->isEmpty())
+		return false;
+
+	ScopedSpan span("skew/pyramid");
+
+	double lo = mMinAngle;
+	double hi = mMaxAngle;
+	double step = 0;
+	double bestScore = 0;
+	int height = 0;
+	QVector<cv::Point2f> pts;
+	mNumLevels = 0;
+
+	for (int lIdx = mPre->numLevels() - 1; lIdx >= 0; lIdx--) {
+
+		cv::Mat l = mPre->level(lIdx);
+		pts = mPre->foreground(lIdx);
+		height = l.rows + l.cols;
+
+		if (pts.empty())
+			return false;
+
+		// 1 px shift at the half width
+		step = std::atan(2.0 / qMax(l.cols, 1));
+
+		mAngle = search(pts, height, lo, hi, step, bestScore);
+		mNumLevels++;
+
+		// refine in a narrow band at the next level
+		lo = qMax(mAngle - 2 * step, mMinAngle);
+		hi = qMin(mAngle + 2 * step, mMaxAngle);
+
+		if (step <= mPrecision)
+			break;
+	}
+
+	// sub-step interpolation (parabola through the best angle & its neighbors)
+	double sl = score(pts, mAngle - step, height);
+	double sr = score(pts, mAngle + step, height);
+	double d = sl - 2 * bestScore + sr;
+
+	if (d < 0)
+		mAngle += qBound(-0.5, 0.5 * (sl - sr) / d, 0.5) * step;
+
+	mConfidence = bestScore > 0 ? 1.0 - qMax(sl, sr) / bestScore : 0.0;
+
+	return true;
+}
+
+/// <summary>
+/// The angle (rad) that deskews the image if it is rotated
+/// with cv::getRotationMatrix2D (positive = counter-clockwise).
+/// </summary>
+double PyramidSkewEstimation::angle() const {
+	return mAngle;
+}
+
+/// <summary>
+/// How distinct the peak of the score is [0 1].
+/// </summary>
+double PyramidSkewEstimation::confidence() const {
+	return mConfidence;
+}
+
+int PyramidSkewEstimation::numLevels() const {
+	return mNumLevels;
+}
+
+/// <summary>
+/// Energy of the horizontal projection profile if the points are rotated by angle.
+/// Points are relative to the image center.
+/// </summary>
+double PyramidSkewEstimation::score(const QVector<cv::Point2f>& pts, double angle, int height) {
+
+	// y' of cv::getRotationMatrix2D
+	float sa = (float)-std::sin(angle);
+	float ca = (float)std::cos(angle);
+
+	QVector<int> hist(height + 2, 0);
+	int* h = hist.data();
+	float off = height * 0.5f + 0.5f;
+
+	for (const cv::Point2f& p : pts) {
+		int b = (int)(sa * p.x + ca * p.y + off);
+		if (b >= 0 && b < hist.size())
+			h[b]++;
+	}
+
+	double s = 0;
+	for (int v : hist)
+		s += (double)v * v;
+
+	return s;
+}
+
+/// <summary>
+/// Returns the best angle in [lo hi] - angles are scored in parallel.
+/// </summary>
+double PyramidSkewEstimation::search(const QVector<cv::Point2f>& pts, int height, double lo, double hi, double step, double& bestScore) const {
+
+	int n = qMax(1, qRound((hi - lo) / step) + 1);
+	QVector<double> scores(n, 0.0);
+	double* sPtr = scores.data();
+
+	cv::parallel_for_(cv::Range(0, n), [&](const cv::Range& range) {
+		for (int idx = range.start; idx < range.end; idx++)
+			sPtr[idx] = score(pts, lo + idx * step, height);
+	});
+
+	int bestIdx = 0;
+	for (int idx = 1; idx < n; idx++) {
+		if (scores[idx] > scores[bestIdx])
+			bestIdx = idx;
+	}
+
+	bestScore = scores[bestIdx];
+
+	return lo + bestIdx * step;
+}
+
+};
@@ -0,0 +1,99 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QSharedPointer>
+#include <QVector>
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+class SkewPreprocessing;
+
+/// <summary>
+/// Coarse-to-fine skew estimation on an image pyramid.
+/// The full angle range is searched on a heavily downsampled image.
+/// Higher resolutions only refine the angle in a narrow band around
+/// the previous estimate. The angular step halves with each level
+/// (1 px shift at the page's half width) and levels that are finer than
+/// the requested precision are never computed.
+/// Each angle is scored with the energy of the horizontal projection
+/// profile of the (Otsu) foreground pixels (Postl's method).
+/// The pyramid & foreground can be shared with other estimators (setPreprocessing).
+/// </summary>
+class DllRdmExport PyramidSkewEstimation {
+
+public:
+	PyramidSkewEstimation(const cv::Mat& img = cv::Mat());
+
+	void setPreprocessing(const QSharedPointer<SkewPreprocessing>& pre);
+
+	void setRange(double minAngle, double maxAngle);
+	void setCoarseSize(int coarseSize);
+	void setPrecision(double precision);
+
+	bool compute();
+
+	double angle() const;
+	double confidence() const;
+	int numLevels() const;
+
+	static double score(const QVector<cv::Point2f>& pts, double angle, int height);
+
+private:
+	cv::Mat mImg;
+	QSharedPointer<SkewPreprocessing> mPre;
+
+	double mMinAngle = -15 * CV_PI / 180.0;	// rad
+	double mMaxAngle = 15 * CV_PI / 180.0;	// rad
+	int mCoarseSize = 512;					// px - max side of the coarsest level
+	double mPrecision = 0.05 * CV_PI / 180.0;	// rad
+
+	double mAngle = 0;
+	double mConfidence = 0;
+	int mNumLevels = 0;
+
+	double search(const QVector<cv::Point2f>& pts, int height, double lo, double hi, double step, double& bestScore) const;
+};
+
+};
@@ -0,0 +1,519 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "Rotation.h"
+
+// ReadModules
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QDebug>
+#include <QVector>
+
+#include <cmath>
+#include <cstring>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+Rotation::Rotation(double angle, Interpolation interp) {
+	mAngle = angle;
+	mInterp = interp;
+}
+
+void Rotation::setInterpolation(Interpolation interp) {
+	mInterp = interp;
+}
+
+/// <summary>
+/// Sets the value of pixels rotated in from outside the image.
+/// Use 0 for binary images (text = 255).
+/// </summary>
+void Rotation::setBorderValue(int value) {
+	mBorder = value;
+}
+
+void Rotation::setTileSize(int tileSize) {
+	mTileSize = tileSize;
+}
+
+/// <summary>
+/// Angles (rad) below this are rotated with shears (default: 0 - disabled).
+/// Shears trade two extra page buffers & blur for row-wise passes.
+/// </summary>
+void Rotation::setShearMaxAngle(double angle) {
+	mShearMaxAngle = angle;
+}
+
+bool Rotation::useShear() const {
+	return std::abs(mAngle) < mShearMaxAngle;
+}
+
+/// <summary>
+/// Rotates img - supported formats are kept (Grayscale8, RGB888, (A)RGB32, Mono).
+/// Other formats are converted to ARGB32 (or Grayscale8 if the image is gray).
+/// </summary>
+QImage Rotation::rotate(const QImage& img) const {
+
+	if (img.isNull() || mAngle == 0.0)
+		return img;
+
+	ScopedSpan span("rotation");
+
+	QImage src = img;
+	int cn = 0;
+
+	switch (src.format()) {
+	case QImage::Format_MonoLSB:
+		src = src.convertToFormat(QImage::Format_Mono);
+		// fall through
+	case QImage::Format_Mono:
+		break;
+	case QImage::Format_Grayscale8:
+		cn = 1;
+		break;
+	case QImage::Format_RGB888:
+		cn = 3;
+		break;
+	case QImage::Format_RGB32:
+	case QImage::Format_ARGB32:
+	case QImage::Format_ARGB32_Premultiplied:
+		cn = 4;
+		break;
+	default:
+		if (src.isGrayscale()) {
+			src = src.convertToFormat(QImage::Format_Grayscale8);
+			cn = 1;
+		}
+		else {
+			src = src.convertToFormat(QImage::Format_ARGB32);
+			cn = 4;
+		}
+	}
+
+	QImage dst(src.size(), src.format());
+	Buffer s(src.constBits(), src.bytesPerLine(), src.width(), src.height(), cn);
+	Buffer d(dst.bits(), dst.bytesPerLine(), dst.width(), dst.height(), cn);
+
+	if (src.format() == QImage::Format_Mono) {
+
+		// the border bit is the color closest to the border value
+		QVector<QRgb> ct = src.colorTable();
+		dst.setColorTable(ct);
+
+		uchar border = 0;
+		if (ct.size() == 2)
+			border = std::abs(qGray(ct[1]) - mBorder) < std::abs(qGray(ct[0]) - mBorder) ? 1 : 0;
+
+		rotateMono(s, d, border);
+	}
+	else
+		rotate(s, d);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+	span.addBytes(dst.sizeInBytes());
+#else
+	span.addBytes(dst.byteCount());
+#endif
+
+	return dst;
+}
+
+cv::Mat Rotation::rotate(const cv::Mat& img) const {
+
+	cv::Mat dst;
+	rotate(img, dst);
+
+	return dst;
+}
+
+/// <summary>
+/// Rotates src into dst (CV_8UC1, CV_8UC3 or CV_8UC4).
+/// dst is (re-)allocated if it does not match src.
+/// </summary>
+void Rotation::rotate(const cv::Mat& src, cv::Mat& dst) const {
+
+	if (src.empty())
+		return;
+
+	CV_Assert(src.depth() == CV_8U && src.channels() <= 4);
+
+	if (mAngle == 0.0) {
+		src.copyTo(dst);
+		return;
+	}
+
+	ScopedSpan span("rotation");
+
+	dst.create(src.size(), src.type());
+
+	Buffer s(src.data, src.step, src.cols, src.rows, src.channels());
+	Buffer d(dst.data, dst.step, dst.cols, dst.rows, dst.channels());
+	rotate(s, d);
+
+	span.addBytes(dst);
+}
+
+void Rotation::rotate(const Buffer& src, const Buffer& dst) const {
+
+	if (useShear())
+		rotateShear(src, dst);
+	else
+		rotateTiled(src, dst);
+}
+
+/// <summary>
+/// Inverse mapping: each output tile walks the source with fixed point (16.16) increments.
+/// </summary>
+void Rotation::rotateTiled(const Buffer& src, const Buffer& dst) const {
+
+	const double ca = std::cos(mAngle);
+	const double sa = std::sin(mAngle);
+	const double cx = (src.width - 1) * 0.5;
+	const double cy = (src.height - 1) * 0.5;
+
+	const int64_t one = 1 << 16;
+	const int64_t dx = (int64_t)std::llround(ca * one);	// per output column
+	const int64_t dy = (int64_t)std::llround(sa * one);
+
+	const int ts = qMax(mTileSize, 8);
+	const int tCols = (dst.width + ts - 1) / ts;
+	const int tRows = (dst.height + ts - 1) / ts;
+	const int cn = src.cn;
+	const uchar border = (uchar)mBorder;
+	const bool bilinear = mInterp == interp_bilinear;
+
+	cv::parallel_for_(cv::Range(0, tCols * tRows), [&](const cv::Range& range) {
+
+		for (int tIdx = range.start; tIdx < range.end; tIdx++) {
+
+			int tx = (tIdx % tCols) * ts;
+			int ty = (tIdx / tCols) * ts;
+			int tw = qMin(ts, dst.width - tx);
+			int th = qMin(ts, dst.height - ty);
+
+			for (int rIdx = ty; rIdx < ty + th; rIdx++) {
+
+				uchar* dPtr = dst.data + rIdx * dst.step + tx * cn;
+
+				// source position of the tile row's first pixel
+				double ox = tx - cx;
+				double oy = rIdx - cy;
+				int64_t sx = (int64_t)std::llround((ca * ox - sa * oy + cx) * one);
+				int64_t sy = (int64_t)std::llround((sa * ox + ca * oy + cy) * one);
+
+				for (int cIdx = 0; cIdx < tw; cIdx++, sx += dx, sy += dy, dPtr += cn) {
+
+					if (bilinear) {
+
+						int64_t xi = sx >> 16;
+						int64_t yi = sy >> 16;
+
+						if (xi < 0 || yi < 0 || xi >= src.width - 1 || yi >= src.height - 1) {
+
+							// the last row/column - or outside
+							int64_t xn = (sx + (one >> 1)) >> 16;
+							int64_t yn = (sy + (one >> 1)) >> 16;
+							bool inside = xn >= 0 && yn >= 0 && xn < src.width && yn < src.height;
+							const uchar* sPtr = inside ? src.row((int)yn) + xn * cn : 0;
+
+							for (int k = 0; k < cn; k++)
+								dPtr[k] = sPtr ? sPtr[k] : border;
+							continue;
+						}
+
+						int fx = (int)((sx >> 8) & 0xFF);
+						int fy = (int)((sy >> 8) & 0xFF);
+
+						const uchar* p0 = src.row((int)yi) + xi * cn;
+						const uchar* p1 = p0 + src.step;
+
+						for (int k = 0; k < cn; k++) {
+							int t = p0[k] * (256 - fx) + p0[k + cn] * fx;
+							int b = p1[k] * (256 - fx) + p1[k + cn] * fx;
+							dPtr[k] = (uchar)((t * (256 - fy) + b * fy + (1 << 15)) >> 16);
+						}
+					}
+					else {
+
+						int64_t xn = (sx + (one >> 1)) >> 16;
+						int64_t yn = (sy + (one >> 1)) >> 16;
+
+						if (xn < 0 || yn < 0 || xn >= src.width || yn >= src.height) {
+							for (int k = 0; k < cn; k++)
+								dPtr[k] = border;
+						}
+						else {
+							const uchar* sPtr = src.row((int)yn) + xn * cn;
+							for (int k = 0; k < cn; k++)
+								dPtr[k] = sPtr[k];
+						}
+					}
+				}
+			}
+		}
+	});
+}
+
+/// <summary>
+/// Paeth rotation: R = Sx(t) * Sy(-s) * Sx(t) with t = tan(a/2) and s = sin(a).
+/// The intermediate buffers are padded so that no content is clipped.
+/// </summary>
+void Rotation::rotateShear(const Buffer& src, const Buffer& dst) const {
+
+	const double t = std::tan(mAngle * 0.5);
+	const double s = std::sin(mAngle);
+	const double cx = (src.width - 1) * 0.5;
+	const double cy = (src.height - 1) * 0.5;
+	const int cn = src.cn;
+
+	// columns read by the last row pass & rows read by the column pass
+	int px = (int)std::ceil(std::abs(t) * (src.height * 0.5)) + 2;
+	int py = (int)std::ceil(std::abs(s) * (src.width * 0.5 + px)) + 2;
+
+	int bw = src.width + 2 * px;
+	cv::Mat b1(src.height + 2 * py, bw * cn, CV_8UC1);
+	cv::Mat b2(src.height, bw * cn, CV_8UC1);
+
+	Buffer s1(b1.data, b1.step, bw, b1.rows, cn, -px, -py);
+	Buffer s2(b2.data, b2.step, bw, b2.rows, cn, -px, 0);
+
+	shearRows(src, s1, t, cy);
+	shearCols(s1, s2, -s, cx);
+	shearRows(s2, dst, t, cy);
+}
+
+/// <summary>
+/// dst(x, y) = src(x - k * (y - cy), y) - the interpolation weights are constant per row.
+/// </summary>
+void Rotation::shearRows(const Buffer& src, const Buffer& dst, double k, double cy) const {
+
+	const int cn = src.cn;
+	const uchar border = (uchar)mBorder;
+	const bool bilinear = mInterp == interp_bilinear;
+
+	cv::parallel_for_(cv::Range(0, dst.height), [&](const cv::Range& range) {
+
+		for (int rIdx = range.start; rIdx < range.end; rIdx++) {
+
+			uchar* dPtr = dst.data + rIdx * dst.step;
+			int sr = rIdx + dst.y0 - src.y0;
+
+			if (sr < 0 || sr >= src.height) {
+				memset(dPtr, border, (size_t)dst.width * cn);
+				continue;
+			}
+
+			const uchar* sPtr = src.row(sr);
+
+			// source column of dst column 0
+			double xs = dst.x0 - k * (rIdx + dst.y0 - cy) - src.x0;
+			
+			if (!bilinear)
+				xs = std::floor(xs + 0.5);
+
+			int base = (int)std::floor(xs);
+			int w1 = qRound((xs - base) * 256);
+			
+			if (w1 == 256) {
+				base++;
+				w1 = 0;
+			}
+
+			int w0 = 256 - w1;
+
+			// dst columns that read two valid source columns
+			int lo = qBound(0, -base, dst.width);
+			int hi = qBound(lo, src.width - 1 - base, dst.width);
+
+			for (int cIdx = 0; cIdx < lo; cIdx++) {
+				for (int c = 0; c < cn; c++)
+					dPtr[cIdx * cn + c] = (cIdx + base == -1 && w1) ? (uchar)((border * w0 + sPtr[c] * w1 + 128) >> 8) : border;
+			}
+
+			const uchar* s0 = sPtr + base * cn;
+
+			if (w1 == 0)
+				memcpy(dPtr + lo * cn, s0 + lo * cn, (size_t)(hi - lo) * cn);
+			else {
+				for (int bIdx = lo * cn; bIdx < hi * cn; bIdx++)
+					dPtr[bIdx] = (uchar)((s0[bIdx] * w0 + s0[bIdx + cn] * w1 + 128) >> 8);
+			}
+
+			for (int cIdx = hi; cIdx < dst.width; cIdx++) {
+				int sc = cIdx + base;
+				for (int c = 0; c < cn; c++)
+					dPtr[cIdx * cn + c] = (sc == src.width - 1) ? (uchar)((sPtr[sc * cn + c] * w0 + border * w1 + 128) >> 8) : border;
+			}
+		}
+	});
+}
+
+/// <summary>
+/// dst(x, y) = src(x, y - k * (x - cx)) - src and dst share their columns.
+/// The row offsets & weights are precomputed per column.
+/// </summary>
+void Rotation::shearCols(const Buffer& src, const Buffer& dst, double k, double cx) const {
+
+	const int cn = src.cn;
+	const uchar border = (uchar)mBorder;
+	const bool bilinear = mInterp == interp_bilinear;
+
+	QVector<int> offsets(dst.width);
+	QVector<int> weights(dst.width);
+
+	for (int cIdx = 0; cIdx < dst.width; cIdx++) {
+
+		double ys = dst.y0 - k * (cIdx + dst.x0 - cx) - src.y0;
+		
+		if (!bilinear)
+			ys = std::floor(ys + 0.5);
+
+		int base = (int)std::floor(ys);
+		int w1 = qRound((ys - base) * 256);
+
+		if (w1 == 256) {
+			base++;
+			w1 = 0;
+		}
+
+		offsets[cIdx] = base;
+		weights[cIdx] = w1;
+	}
+
+	const int* oPtr = offsets.constData();
+	const int* wPtr = weights.constData();
+
+	cv::parallel_for_(cv::Range(0, dst.height), [&](const cv::Range& range) {
+
+		for (int rIdx = range.start; rIdx < range.end; rIdx++) {
+
+			uchar* dPtr = dst.data + rIdx * dst.step;
+
+			for (int cIdx = 0; cIdx < dst.width; cIdx++) {
+
+				int r0 = rIdx + oPtr[cIdx];
+				int w1 = wPtr[cIdx];
+				int w0 = 256 - w1;
+
+				const uchar* p0 = (r0 >= 0 && r0 < src.height) ? src.row(r0) + cIdx * cn : 0;
+				const uchar* p1 = (w1 && r0 + 1 >= 0 && r0 + 1 < src.height) ? src.row(r0 + 1) + cIdx * cn : 0;
+
+				for (int c = 0; c < cn; c++) {
+					int v0 = p0 ? p0[c] : border;
+					int v1 = p1 ? p1[c] : border;
+					dPtr[cIdx * cn + c] = (uchar)((v0 * w0 + v1 * w1 + 128) >> 8);
+				}
+			}
+		}
+	});
+}
+
+/// <summary>
+/// Nearest neighbor rotation of packed 1 bit images (MSB first).
+/// Tiles are multiples of 8 px wide so that threads never share output bytes.
+/// </summary>
+void Rotation::rotateMono(const Buffer& src, const Buffer& dst, uchar border) const {
+
+	const double ca = std::cos(mAngle);
+	const double sa = std::sin(mAngle);
+	const double cx = (src.width - 1) * 0.5;
+	const double cy = (src.height - 1) * 0.5;
+
+	const int64_t one = 1 << 16;
+	const int64_t dx = (int64_t)std::llround(ca * one);
+	const int64_t dy = (int64_t)std::llround(sa * one);
+
+	const int ts = qMax(mTileSize / 8, 1) * 8;
+	const int tCols = (dst.width + ts - 1) / ts;
+	const int tRows = (dst.height + ts - 1) / ts;
+
+	cv::parallel_for_(cv::Range(0, tCols * tRows), [&](const cv::Range& range) {
+
+		for (int tIdx = range.start; tIdx < range.end; tIdx++) {
+
+			int tx = (tIdx % tCols) * ts;
+			int ty = (tIdx / tCols) * ts;
+			int tw = qMin(ts, dst.width - tx);
+			int th = qMin(ts, dst.height - ty);
+
+			for (int rIdx = ty; rIdx < ty + th; rIdx++) {
+
+				uchar* dPtr = dst.data + rIdx * dst.step + tx / 8;
+
+				double ox = tx - cx;
+				double oy = rIdx - cy;
+				int64_t sx = (int64_t)std::llround((ca * ox - sa * oy + cx) * one) + (one >> 1);
+				int64_t sy = (int64_t)std::llround((sa * ox + ca * oy + cy) * one) + (one >> 1);
+
+				uchar byte = 0;
+				for (int cIdx = 0; cIdx < tw; cIdx++, sx += dx, sy += dy) {
+
+					int64_t xn = sx >> 16;
+					int64_t yn = sy >> 16;
+
+					uchar bit = border;
+					if (xn >= 0 && yn >= 0 && xn < src.width && yn < src.height)
+						bit = (src.row((int)yn)[xn >> 3] >> (7 - (xn & 7))) & 1;
+
+					byte = (uchar)((byte << 1) | bit);
+
+					if ((cIdx & 7) == 7) {
+						*dPtr++ = byte;
+						byte = 0;
+					}
+				}
+
+				// last (partial) byte of the row
+				if (tw & 7)
+					*dPtr = (uchar)(byte << (8 - (tw & 7)));
+			}
+		}
+	});
+}
+
+// Rotation::Buffer --------------------------------------------------------------------
+Rotation::Buffer::Buffer(const uchar* data, size_t step, int width, int height, int cn, int x0, int y0) {
+	this->data = const_cast<uchar*>(data);
+	this->step = step;
+	this->width = width;
+	this->height = height;
+	this->cn = cn;
+	this->x0 = x0;
+	this->y0 = y0;
+}
+
+const uchar* Rotation::Buffer::row(int r) const {
+	return data + r * step;
+}
+
+};
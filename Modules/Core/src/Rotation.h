@@ -0,0 +1,115 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QImage>
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Rotates (deskews) images around their center, keeping the image size.
+/// The angle follows rdf::IP::rotateImage (rad, positive = counter-clockwise).
+/// Output tiles are processed in parallel. Source coordinates are advanced
+/// with fixed point increments per pixel (recomputed per tile row).
+/// Optionally, small angles are rotated with three shears (Paeth, see
+/// setShearMaxAngle). Each pass moves whole rows (or columns) with constant
+/// weights, but it needs two padded page buffers and interpolates three times.
+/// So it is off by default.
+/// QImages are written directly into the result's buffer (no cvtColor).
+/// 1 bit images (Format_Mono) are rotated without unpacking (nearest neighbor).
+/// </summary>
+class DllRdmExport Rotation {
+
+public:
+	enum Interpolation {
+		interp_nearest = 0,
+		interp_bilinear,
+
+		interp_end
+	};
+
+	Rotation(double angle = 0.0, Interpolation interp = interp_bilinear);
+
+	void setInterpolation(Interpolation interp);
+	void setBorderValue(int value);
+	void setTileSize(int tileSize);
+	void setShearMaxAngle(double angle);
+
+	QImage rotate(const QImage& img) const;
+	cv::Mat rotate(const cv::Mat& img) const;
+	void rotate(const cv::Mat& src, cv::Mat& dst) const;
+
+	bool useShear() const;
+
+private:
+	struct Buffer {
+		Buffer(const uchar* data = 0, size_t step = 0, int width = 0, int height = 0, int cn = 1, int x0 = 0, int y0 = 0);
+
+		uchar* data;
+		size_t step;
+		int width;
+		int height;
+		int cn;
+		int x0;		// position of the first column in the source's frame
+		int y0;		// position of the first row in the source's frame
+
+		const uchar* row(int r) const;
+	};
+
+	double mAngle = 0.0;					// rad
+	Interpolation mInterp = interp_bilinear;
+	int mBorder = 255;						// white paper
+	int mTileSize = 256;					// px
+	double mShearMaxAngle = 0.0;			// rad - shears are opt-in
+
+	void rotate(const Buffer& src, const Buffer& dst) const;
+	void rotateTiled(const Buffer& src, const Buffer& dst) const;
+	void rotateShear(const Buffer& src, const Buffer& dst) const;
+	void rotateMono(const Buffer& src, const Buffer& dst, uchar border) const;
+
+	void shearRows(const Buffer& src, const Buffer& dst, double k, double cy) const;
+	void shearCols(const Buffer& src, const Buffer& dst, double k, double cx) const;
+};
+
+};
@@ -0,0 +1,181 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "SkewPreprocessing.h"
+
+// ReadModules
+#include "Threshold.h"
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+SkewPreprocessing::SkewPreprocessing(const cv::Mat& img, int coarseSize) {
+	mImg = img;
+	mCoarseSize = coarseSize;
+}
+
+/// <summary>
+/// Converts the image to gray.
+/// The pyramid is built when it is first accessed - estimators
+/// that work on the gray image only do not need it.
+/// </summary>
+/// <returns>false if the image is empty</returns>
+bool SkewPreprocessing::compute() {
+
+	if (mImg.empty())
+		return false;
+
+	ScopedSpan span("skew/preprocessing");
+
+	cv::Mat img = mImg;
+	if (img.channels() == 4)
+		cv::cvtColor(img, img, cv::COLOR_BGRA2GRAY);
+	else if (img.channels() == 3)
+		cv::cvtColor(img, img, cv::COLOR_BGR2GRAY);
+
+	mGray = img;
+
+	QMutexLocker l(&mMutex);
+	mPyramid.clear();
+	mForeground.clear();
+	mForegroundValid.clear();
+
+	return true;
+}
+
+bool SkewPreprocessing::isEmpty() const {
+	return mGray.empty();
+}
+
+cv::Mat SkewPreprocessing::gray() const {
+	return mGray;
+}
+
+int SkewPreprocessing::numLevels() const {
+
+	QMutexLocker l(&mMutex);
+	buildPyramid();
+
+	return mPyramid.size();
+}
+
+/// <summary>
+/// Returns a pyramid level (0 = full resolution).
+/// </summary>
+cv::Mat SkewPreprocessing::level(int idx) const {
+
+	if (idx == 0)
+		return mGray;
+
+	QMutexLocker l(&mMutex);
+	buildPyramid();
+
+	if (idx < 0 || idx >= mPyramid.size())
+		return cv::Mat();
+
+	return mPyramid[idx];
+}
+
+/// <summary>
+/// Foreground (Otsu) pixels of a level relative to its center.
+/// Large levels are sampled with a regular stride.
+/// </summary>
+QVector<cv::Point2f> SkewPreprocessing::foreground(int idx) const {
+
+	QMutexLocker l(&mMutex);
+	buildPyramid();
+
+	if (idx < 0 || idx >= mPyramid.size())
+		return QVector<cv::Point2f>();
+
+	if (mForegroundValid[idx])
+		return mForeground[idx];
+
+	const cv::Mat& img = mPyramid[idx];
+	cv::Mat bw = Threshold::otsu(img);
+	int n = cv::countNonZero(bw);
+
+	int stride = qMax(1, n / mMaxPoints);
+	float cx = img.cols * 0.5f;
+	float cy = img.rows * 0.5f;
+
+	QVector<cv::Point2f> pts;
+	pts.reserve(n / stride + 1);
+
+	int pIdx = 0;
+	for (int rIdx = 0; rIdx < bw.rows; rIdx++) {
+
+		const unsigned char* ptr = bw.ptr<unsigned char>(rIdx);
+		for (int cIdx = 0; cIdx < bw.cols; cIdx++) {
+			if (ptr[cIdx] && pIdx++ % stride == 0)
+				pts << cv::Point2f(cIdx - cx, rIdx - cy);
+		}
+	}
+
+	mForeground[idx] = pts;
+	mForegroundValid[idx] = true;
+
+	return pts;
+}
+
+void SkewPreprocessing::setMaxPoints(int maxPoints) {
+	mMaxPoints = maxPoints;
+}
+
+/// <summary>
+/// Reduces the gray image until its max side is at most coarseSize.
+/// NOTE: the caller has to lock the mutex.
+/// </summary>
+void SkewPreprocessing::buildPyramid() const {
+
+	if (!mPyramid.empty() || mGray.empty())
+		return;
+
+	ScopedSpan span("skew/buildPyramid");
+
+	mPyramid << mGray;
+
+	while (mCoarseSize > 0 && qMax(mPyramid.last().cols, mPyramid.last().rows) > mCoarseSize) {
+		cv::Mat l;
+		cv::pyrDown(mPyramid.last(), l);
+		mPyramid << l;
+	}
+
+	mForeground = QVector<QVector<cv::Point2f> >(mPyramid.size());
+	mForegroundValid = QVector<bool>(mPyramid.size(), false);
+}
+
+};
@@ -0,0 +1,89 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QMutex>
+#include <QVector>
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Preprocessing shared by all skew estimators of a page.
+/// It is computed once and handed to each estimator:
+/// - the gray image (input of rdf::BaseSkewEstimation & rdf::TextLineSkew)
+/// - a gray pyramid (finest first) down to coarseSize px (built on first access)
+/// - the Otsu foreground pixels per level (computed on demand)
+/// </summary>
+class DllRdmExport SkewPreprocessing {
+
+public:
+	SkewPreprocessing(const cv::Mat& img = cv::Mat(), int coarseSize = 512);
+
+	bool compute();
+	bool isEmpty() const;
+
+	cv::Mat gray() const;
+
+	int numLevels() const;
+	cv::Mat level(int idx) const;
+	QVector<cv::Point2f> foreground(int idx) const;
+
+	void setMaxPoints(int maxPoints);
+
+private:
+	cv::Mat mImg;
+	int mCoarseSize = 512;		// px - max side of the coarsest level
+	int mMaxPoints = 400000;	// foreground pixels sampled per level
+
+	cv::Mat mGray;
+
+	mutable QMutex mMutex;
+	mutable QVector<cv::Mat> mPyramid;
+	mutable QVector<QVector<cv::Point2f> > mForeground;
+	mutable QVector<bool> mForegroundValid;
+
+	void buildPyramid() const;
+};
+
+};
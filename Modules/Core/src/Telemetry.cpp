@@ -0,0 +1,321 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "Telemetry.h"
+
+// ReadFramework
+#include "Settings.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <opencv2/core/core.hpp>
+
+#ifdef WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+namespace {
+	thread_local QString gPage;
+	thread_local int gDepth = 0;
+}
+
+// TelemetrySpan --------------------------------------------------------------------
+QJsonObject TelemetrySpan::toJson() const {
+
+	QJsonObject jo;
+	jo["name"] = name;
+	jo["wall_ms"] = wallMs;
+	jo["cpu_ms"] = cpuMs;
+	jo["peak_rss_delta"] = (double)peakRssDelta;
+	jo["bytes"] = (double)bytes;
+	jo["depth"] = depth;
+
+	return jo;
+}
+
+// ScopedSpan --------------------------------------------------------------------
+ScopedSpan::ScopedSpan(const QString& name) {
+
+	mSpan.name = name;
+	mSpan.page = gPage;
+	mSpan.depth = gDepth++;
+
+	mPeakRssStart = Telemetry::peakRss();
+	mCpuStart = Telemetry::threadCpuMs();
+	mTimer.start();
+}
+
+ScopedSpan::~ScopedSpan() {
+
+	mSpan.wallMs = mTimer.nsecsElapsed() / 1e6;
+	mSpan.cpuMs = Telemetry::threadCpuMs() - mCpuStart;
+	mSpan.peakRssDelta = Telemetry::peakRss() - mPeakRssStart;
+	gDepth--;
+
+	Telemetry::instance().add(mSpan);
+}
+
+void ScopedSpan::addBytes(qint64 bytes) {
+	mSpan.bytes += bytes;
+}
+
+void ScopedSpan::addBytes(const cv::Mat& img) {
+	mSpan.bytes += (qint64)(img.total() * img.elemSize());
+}
+
+/// <summary>
+/// Returns the wall time (in ms) since the span was opened.
+/// </summary>
+double ScopedSpan::elapsed() const {
+	return mTimer.nsecsElapsed() / 1e6;
+}
+
+// TelemetryPage --------------------------------------------------------------------
+TelemetryPage::TelemetryPage(const QString& filePath) {
+	mLastPage = gPage;
+	gPage = filePath;
+}
+
+TelemetryPage::~TelemetryPage() {
+	gPage = mLastPage;
+}
+
+// Telemetry --------------------------------------------------------------------
+Telemetry::Telemetry() {
+
+	rdf::DefaultSettings s;
+	s.beginGroup("Telemetry");
+	mLogPath = s.value("logPath", mLogPath).toString();
+	mMaxPages = s.value("maxPages", mMaxPages).toInt();
+	s.endGroup();
+
+	QString envPath = QString::fromLocal8Bit(qgetenv("RDM_TELEMETRY"));
+	if (!envPath.isEmpty())
+		mLogPath = envPath;
+}
+
+Telemetry& Telemetry::instance() {
+
+	static Telemetry inst;
+	return inst;
+}
+
+void Telemetry::add(const TelemetrySpan& span) {
+
+	QMutexLocker l(&mMutex);
+
+	auto it = mSpans.find(span.page);
+	if (it == mSpans.end()) {
+
+		// nobody flushes (e.g. plugins in the GUI) - do not grow forever
+		if (mMaxPages > 0 && mPages.size() >= mMaxPages)
+			write();
+
+		mPages << span.page;
+		it = mSpans.insert(span.page, QVector<TelemetrySpan>());
+	}
+
+	it->append(span);
+}
+
+/**
+* Writes all spans collected so far as JSON lines and clears them.
+* Each page results in one line:
+* {"page": "img.tif", "spans": [{"name": "layout/compute", "wall_ms": ...}, ...]}
+* The last line summarizes the spans by name.
+**/
+void Telemetry::flush() {
+
+	QMutexLocker l(&mMutex);
+	write();
+}
+
+/// <summary>
+/// Writes and clears the spans (see flush()).
+/// NOTE: the caller has to lock the mutex.
+/// </summary>
+void Telemetry::write() {
+
+	if (mPages.isEmpty())
+		return;
+
+	qInfo().noquote() << summary();
+
+	if (!mLogPath.isEmpty()) {
+
+		QFile file(mLogPath);
+
+		if (file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+
+			QTextStream ts(&file);
+
+			for (const QString& p : mPages) {
+
+				QJsonArray ja;
+				for (const TelemetrySpan& s : mSpans.value(p))
+					ja << s.toJson();
+
+				QJsonObject jo;
+				jo["page"] = p;
+				jo["spans"] = ja;
+
+				ts << QJsonDocument(jo).toJson(QJsonDocument::Compact) << "\n";
+			}
+
+			qInfo() << "telemetry of" << mPages.size() << "pages written to" << mLogPath;
+		}
+		else
+			qWarning() << "could not open" << mLogPath << "for writing";
+	}
+
+	mPages.clear();
+	mSpans.clear();
+}
+
+void Telemetry::setLogPath(const QString& logPath) {
+
+	QMutexLocker l(&mMutex);
+	mLogPath = logPath;
+}
+
+QString Telemetry::logPath() const {
+
+	QMutexLocker l(&mMutex);
+	return mLogPath;
+}
+
+/// <summary>
+/// Returns the total & mean times of all spans (by name).
+/// NOTE: the caller has to lock the mutex.
+/// </summary>
+QString Telemetry::summary() const {
+
+	QMap<QString, TelemetrySpan> sums;
+	QMap<QString, int> counts;
+
+	for (const QVector<TelemetrySpan>& spans : mSpans) {
+		for (const TelemetrySpan& s : spans) {
+			TelemetrySpan& t = sums[s.name];
+			t.wallMs += s.wallMs;
+			t.cpuMs += s.cpuMs;
+			t.peakRssDelta = qMax(t.peakRssDelta, s.peakRssDelta);
+			t.bytes += s.bytes;
+			counts[s.name]++;
+		}
+	}
+
+	QString msg = "Telemetry (" + QString::number(mPages.size()) + " pages):\n";
+
+	for (auto it = sums.begin(); it != sums.end(); it++) {
+		int n = counts[it.key()];
+		msg += "  " + it.key() + ": " + QString::number(n) + "x, ";
+		msg += "wall " + QString::number(it->wallMs / n, 'f', 1) + " ms, ";
+		msg += "cpu " + QString::number(it->cpuMs / n, 'f', 1) + " ms, ";
+		msg += "peak rss +" + QString::number(it->peakRssDelta / (1024 * 1024)) + " MB, ";
+		msg += QString::number(it->bytes / n / 1024) + " KB\n";
+	}
+
+	return msg;
+}
+
+/// <summary>
+/// Returns the page that is processed by the calling thread.
+/// </summary>
+QString Telemetry::currentPage() {
+	return gPage;
+}
+
+/// <summary>
+/// Returns the CPU time (in ms) the calling thread consumed so far.
+/// </summary>
+double Telemetry::threadCpuMs() {
+
+#ifdef WIN32
+	FILETIME c, e, k, u;
+	if (!GetThreadTimes(GetCurrentThread(), &c, &e, &k, &u))
+		return 0.0;
+
+	ULARGE_INTEGER ki, ui;
+	ki.LowPart = k.dwLowDateTime;
+	ki.HighPart = k.dwHighDateTime;
+	ui.LowPart = u.dwLowDateTime;
+	ui.HighPart = u.dwHighDateTime;
+
+	return (ki.QuadPart + ui.QuadPart) / 1e4;	// 100 ns ticks
+#else
+	timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return 0.0;
+
+	return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#endif
+}
+
+/// <summary>
+/// Returns the peak resident set size of the process in bytes.
+/// </summary>
+qint64 Telemetry::peakRss() {
+
+#ifdef WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return 0;
+
+	return (qint64)pmc.PeakWorkingSetSize;
+#else
+	rusage ru;
+	if (getrusage(RUSAGE_SELF, &ru) != 0)
+		return 0;
+
+#ifdef __APPLE__
+	return (qint64)ru.ru_maxrss;			// bytes
+#else
+	return (qint64)ru.ru_maxrss * 1024;		// KB
+#endif
+#endif
+}
+
+};
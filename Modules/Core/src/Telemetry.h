@@ -0,0 +1,160 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+class QJsonObject;
+
+namespace cv {
+	class Mat;
+}
+
+namespace rdm {
+
+/// <summary>
+/// A finished measurement of a stage.
+/// CPU time is measured for the thread that opened the span,
+/// the peak RSS delta is process wide (it only grows if the stage
+/// raised the process' high-water mark). Bytes are the sizes of
+/// the buffers the stage reported with ScopedSpan::addBytes().
+/// </summary>
+class DllRdmExport TelemetrySpan {
+
+public:
+	QString name;
+	QString page;
+	double wallMs = 0.0;
+	double cpuMs = 0.0;
+	qint64 peakRssDelta = 0;	// bytes
+	qint64 bytes = 0;
+	int depth = 0;
+
+	QJsonObject toJson() const;
+};
+
+/// <summary>
+/// Measures a stage from construction to destruction:
+/// ScopedSpan s("layout/compute");
+/// </summary>
+class DllRdmExport ScopedSpan {
+
+public:
+	ScopedSpan(const QString& name);
+	~ScopedSpan();
+
+	void addBytes(qint64 bytes);
+	void addBytes(const cv::Mat& img);
+
+	double elapsed() const;
+
+private:
+	ScopedSpan(const ScopedSpan&);
+
+	TelemetrySpan mSpan;
+	QElapsedTimer mTimer;
+	double mCpuStart = 0.0;
+	qint64 mPeakRssStart = 0;
+};
+
+/// <summary>
+/// Assigns all spans of the current thread to a page (RAII).
+/// Open it at the beginning of runPlugin().
+/// </summary>
+class DllRdmExport TelemetryPage {
+
+public:
+	TelemetryPage(const QString& filePath);
+	~TelemetryPage();
+
+private:
+	QString mLastPage;
+};
+
+/// <summary>
+/// Collects the spans of all threads and dumps them as JSON lines
+/// (one line per page and a summary line) when flushed - which is
+/// done in postLoadPlugin() and by read-batch. Plugins without a
+/// postLoadPlugin() (e.g. in the GUI) are flushed every
+/// Telemetry/maxPages pages. The log is appended to the file set in
+/// Telemetry/logPath (or the RDM_TELEMETRY environment variable).
+/// Nothing is written if neither is set.
+/// </summary>
+class DllRdmExport Telemetry {
+
+public:
+	static Telemetry& instance();
+
+	void add(const TelemetrySpan& span);
+	void flush();
+
+	void setLogPath(const QString& logPath);
+	QString logPath() const;
+
+	static QString currentPage();
+	static double threadCpuMs();
+	static qint64 peakRss();
+
+private:
+	Telemetry();
+	Telemetry(const Telemetry&);
+
+	mutable QMutex mMutex;
+	QString mLogPath;
+	int mMaxPages = 256;	// pages kept before they are flushed
+	QStringList mPages;		// in order of appearance
+	QHash<QString, QVector<TelemetrySpan> > mSpans;
+
+	void write();
+	QString summary() const;
+
+	friend class TelemetryPage;
+	friend class ScopedSpan;
+};
+
+};
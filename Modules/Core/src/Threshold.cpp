@@ -0,0 +1,428 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "Threshold.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QtGlobal>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RDM_X86_SIMD
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+#pragma warning(pop)		// no warnings from includes - end
+
+// gcc & clang compile AVX2 code per function - MSVC does not need a flag for intrinsics
+#if defined(RDM_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define RDM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RDM_TARGET_AVX2
+#endif
+
+namespace rdm {
+
+namespace {
+
+	// reverses the bits of a byte: the first pixel of 8 goes to the MSB (like QImage::Format_Mono)
+	struct ReverseBits {
+		uchar lut[256];
+
+		ReverseBits() {
+			for (int idx = 0; idx < 256; idx++) {
+				uchar r = 0;
+				for (int b = 0; b < 8; b++) {
+					if (idx & (1 << b))
+						r |= (uchar)(0x80 >> b);
+				}
+				lut[idx] = r;
+			}
+		}
+	};
+
+	const ReverseBits& reverseBits() {
+		static ReverseBits rb;
+		return rb;
+	}
+
+	// scalar kernels ---------------------------------------------------------------------
+	void histogramScalar(const uchar* ptr, int n, int* h0, int* h1, int* h2, int* h3) {
+
+		int idx = 0;
+		for (; idx <= n - 4; idx += 4) {
+			h0[ptr[idx]]++;
+			h1[ptr[idx + 1]]++;
+			h2[ptr[idx + 2]]++;
+			h3[ptr[idx + 3]]++;
+		}
+
+		for (; idx < n; idx++)
+			h0[ptr[idx]]++;
+	}
+
+	// dst = (src > thr) ^ invert ? 255 : 0
+	void thresholdScalar(const uchar* src, uchar* dst, int n, int thr, bool invert) {
+
+		uchar fg = invert ? 0 : 255;
+		uchar bg = invert ? 255 : 0;
+
+		for (int idx = 0; idx < n; idx++)
+			dst[idx] = src[idx] > thr ? fg : bg;
+	}
+
+	// packs 8 pixels per byte (MSB first), bit = 1 if the pixel would be 255 in threshold()
+	void packScalar(const uchar* src, uchar* dst, int n, int thr, bool invert, int start) {
+
+		for (int idx = start; idx < n; idx += 8) {
+
+			uchar b = 0;
+			int end = qMin(idx + 8, n);
+			for (int bi = idx; bi < end; bi++) {
+				if ((src[bi] > thr) != invert)
+					b |= (uchar)(0x80 >> (bi - idx));
+			}
+			dst[idx / 8] = b;
+		}
+	}
+
+#ifdef RDM_X86_SIMD
+
+	// SSE2 kernels ---------------------------------------------------------------------
+	inline void count4(quint32 w, int* h0, int* h1, int* h2, int* h3) {
+		h0[w & 0xff]++;
+		h1[(w >> 8) & 0xff]++;
+		h2[(w >> 16) & 0xff]++;
+		h3[w >> 24]++;
+	}
+
+	inline void count16(__m128i v, int* h0, int* h1, int* h2, int* h3) {
+		count4((quint32)_mm_cvtsi128_si32(v), h0, h1, h2, h3);
+		count4((quint32)_mm_cvtsi128_si32(_mm_srli_si128(v, 4)), h0, h1, h2, h3);
+		count4((quint32)_mm_cvtsi128_si32(_mm_srli_si128(v, 8)), h0, h1, h2, h3);
+		count4((quint32)_mm_cvtsi128_si32(_mm_srli_si128(v, 12)), h0, h1, h2, h3);
+	}
+
+	void histogramSse2(const uchar* ptr, int n, int* h0, int* h1, int* h2, int* h3) {
+
+		int idx = 0;
+		for (; idx <= n - 16; idx += 16)
+			count16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + idx)), h0, h1, h2, h3);
+
+		histogramScalar(ptr + idx, n - idx, h0, h1, h2, h3);
+	}
+
+	// x > thr <=> max(x, thr + 1) == x (unsigned) - thr is in [0 254]
+	inline __m128i greaterSse2(__m128i x, __m128i thr1, __m128i inv) {
+		return _mm_xor_si128(_mm_cmpeq_epi8(_mm_max_epu8(x, thr1), x), inv);
+	}
+
+	void thresholdSse2(const uchar* src, uchar* dst, int n, int thr, bool invert) {
+
+		__m128i thr1 = _mm_set1_epi8((char)(thr + 1));
+		__m128i inv = _mm_set1_epi8(invert ? (char)0xff : 0);
+
+		int idx = 0;
+		for (; idx <= n - 16; idx += 16) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + idx));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + idx), greaterSse2(x, thr1, inv));
+		}
+
+		thresholdScalar(src + idx, dst + idx, n - idx, thr, invert);
+	}
+
+	void packSse2(const uchar* src, uchar* dst, int n, int thr, bool invert) {
+
+		const uchar* lut = reverseBits().lut;
+		__m128i thr1 = _mm_set1_epi8((char)(thr + 1));
+		__m128i inv = _mm_set1_epi8(invert ? (char)0xff : 0);
+
+		int idx = 0;
+		for (; idx <= n - 16; idx += 16) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + idx));
+			int bits = _mm_movemask_epi8(greaterSse2(x, thr1, inv));	// bit i = pixel i
+			dst[idx / 8] = lut[bits & 0xff];
+			dst[idx / 8 + 1] = lut[(bits >> 8) & 0xff];
+		}
+
+		packScalar(src, dst, n, thr, invert, idx);
+	}
+
+	// AVX2 kernels ---------------------------------------------------------------------
+	RDM_TARGET_AVX2 void thresholdAvx2(const uchar* src, uchar* dst, int n, int thr, bool invert) {
+
+		__m256i thr1 = _mm256_set1_epi8((char)(thr + 1));
+		__m256i inv = _mm256_set1_epi8(invert ? (char)0xff : 0);
+
+		int idx = 0;
+		for (; idx <= n - 32; idx += 32) {
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + idx));
+			__m256i r = _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(x, thr1), x), inv);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + idx), r);
+		}
+
+		thresholdScalar(src + idx, dst + idx, n - idx, thr, invert);
+	}
+
+	RDM_TARGET_AVX2 void packAvx2(const uchar* src, uchar* dst, int n, int thr, bool invert) {
+
+		const uchar* lut = reverseBits().lut;
+		__m256i thr1 = _mm256_set1_epi8((char)(thr + 1));
+		__m256i inv = _mm256_set1_epi8(invert ? (char)0xff : 0);
+
+		int idx = 0;
+		for (; idx <= n - 32; idx += 32) {
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + idx));
+			__m256i r = _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(x, thr1), x), inv);
+			quint32 bits = (quint32)_mm256_movemask_epi8(r);
+
+			uchar* d = dst + idx / 8;
+			d[0] = lut[bits & 0xff];
+			d[1] = lut[(bits >> 8) & 0xff];
+			d[2] = lut[(bits >> 16) & 0xff];
+			d[3] = lut[bits >> 24];
+		}
+
+		packScalar(src, dst, n, thr, invert, idx);
+	}
+#endif
+
+	typedef void(*HistFunc)(const uchar*, int, int*, int*, int*, int*);
+	typedef void(*ThreshFunc)(const uchar*, uchar*, int, int, bool);
+	typedef void(*PackFunc)(const uchar*, uchar*, int, int, bool);
+
+	void packScalarRow(const uchar* src, uchar* dst, int n, int thr, bool invert) {
+		packScalar(src, dst, n, thr, invert, 0);
+	}
+}
+
+/// <summary>
+/// Otsu binarization of an 8 bit (or color) image.
+/// </summary>
+/// <param name="img">The input image.</param>
+/// <param name="invert">If true, dark pixels (text) are white - like rdf::IP::threshOtsu.</param>
+/// <returns>A CV_8UC1 image with 0 and 255.</returns>
+cv::Mat Threshold::otsu(const cv::Mat& img, bool invert) {
+
+	cv::Mat gImg = toGray(img);
+
+	int hist[256];
+	histogram(gImg, hist);
+
+	return threshold(gImg, otsuThreshold(hist), invert);
+}
+
+/// <summary>
+/// Computes the 256 bin histogram of a CV_8UC1 image.
+/// </summary>
+void Threshold::histogram(const cv::Mat& img, int* hist) {
+
+	memset(hist, 0, 256 * sizeof(int));
+
+	if (img.empty() || img.type() != CV_8UC1)
+		return;
+
+	// four sub-histograms (one cache line apart)
+	int sub[4][256 + 16];
+	memset(sub, 0, sizeof(sub));
+
+	// the counting is scalar anyway - AVX2 loads would not gain anything over SSE2
+	HistFunc f = histogramScalar;
+#ifdef RDM_X86_SIMD
+	if (isa() >= isa_sse2)
+		f = histogramSse2;
+#endif
+
+	int rows = img.isContinuous() ? 1 : img.rows;
+	int cols = img.isContinuous() ? (int)img.total() : img.cols;
+
+	for (int r = 0; r < rows; r++)
+		f(img.ptr<uchar>(r), cols, sub[0], sub[1], sub[2], sub[3]);
+
+	for (int idx = 0; idx < 256; idx++)
+		hist[idx] = sub[0][idx] + sub[1][idx] + sub[2][idx] + sub[3][idx];
+}
+
+/// <summary>
+/// Otsu's threshold of a 256 bin histogram.
+/// This is the same computation as OpenCV's (cv::THRESH_OTSU).
+/// </summary>
+int Threshold::otsuThreshold(const int* hist) {
+
+	double n = 0, mu = 0;
+	for (int idx = 0; idx < 256; idx++) {
+		n += hist[idx];
+		mu += idx * (double)hist[idx];
+	}
+
+	if (n == 0)
+		return 0;
+
+	double scale = 1.0 / n;
+	mu *= scale;
+
+	double mu1 = 0, q1 = 0;
+	double maxSigma = 0;
+	int maxVal = 0;
+
+	for (int idx = 0; idx < 256; idx++) {
+
+		double pi = hist[idx] * scale;
+		mu1 *= q1;
+		q1 += pi;
+		double q2 = 1.0 - q1;
+
+		if (std::min(q1, q2) < FLT_EPSILON || std::max(q1, q2) > 1.0 - FLT_EPSILON)
+			continue;
+
+		mu1 = (mu1 + idx * pi) / q1;
+		double mu2 = (mu - q1 * mu1) / q2;
+		double sigma = q1 * q2 * (mu1 - mu2) * (mu1 - mu2);
+
+		if (sigma > maxSigma) {
+			maxSigma = sigma;
+			maxVal = idx;
+		}
+	}
+
+	return maxVal;
+}
+
+/// <summary>
+/// Thresholds a CV_8UC1 image: pixels > thr are 255 (0 if inverted).
+/// </summary>
+cv::Mat Threshold::threshold(const cv::Mat& img, int thr, bool invert) {
+
+	cv::Mat gImg = toGray(img);
+	cv::Mat dst(gImg.size(), CV_8UC1);
+
+	// the vector kernels need thr in [0 254]
+	bool vec = thr >= 0 && thr < 255;
+
+	ThreshFunc f = thresholdScalar;
+#ifdef RDM_X86_SIMD
+	if (vec && isa() == isa_avx2)
+		f = thresholdAvx2;
+	else if (vec && isa() == isa_sse2)
+		f = thresholdSse2;
+#endif
+
+	for (int r = 0; r < gImg.rows; r++)
+		f(gImg.ptr<uchar>(r), dst.ptr<uchar>(r), gImg.cols, thr, invert);
+
+	return dst;
+}
+
+/// <summary>
+/// Thresholds and packs 8 pixels into one byte (MSB first, 1 = 255 in threshold()).
+/// The rows of the returned CV_8UC1 matrix have (cols + 7) / 8 bytes.
+/// </summary>
+cv::Mat Threshold::thresholdPacked(const cv::Mat& img, int thr, bool invert) {
+
+	cv::Mat gImg = toGray(img);
+	cv::Mat dst(gImg.rows, (gImg.cols + 7) / 8, CV_8UC1, cv::Scalar(0));
+
+	// the vector kernels need thr in [0 254]
+	bool vec = thr >= 0 && thr < 255;
+
+	PackFunc f = packScalarRow;
+#ifdef RDM_X86_SIMD
+	if (vec && isa() == isa_avx2)
+		f = packAvx2;
+	else if (vec && isa() == isa_sse2)
+		f = packSse2;
+#endif
+
+	for (int r = 0; r < gImg.rows; r++)
+		f(gImg.ptr<uchar>(r), dst.ptr<uchar>(r), gImg.cols, thr, invert);
+
+	return dst;
+}
+
+/// <summary>
+/// The instruction set used by the kernels (the best the CPU supports).
+/// </summary>
+Threshold::Isa Threshold::isa() {
+
+	static const Isa cpuIsa = []() {
+#ifdef RDM_X86_SIMD
+		if (cv::checkHardwareSupport(CV_CPU_AVX2))
+			return isa_avx2;
+		if (cv::checkHardwareSupport(CV_CPU_SSE2))
+			return isa_sse2;
+#endif
+		return isa_scalar;
+	}();
+
+	return qMin(cpuIsa, maxIsa());
+}
+
+/// <summary>
+/// Limits the instruction set (e.g. for benchmarks or comparing kernels).
+/// </summary>
+void Threshold::setMaxIsa(Isa isa) {
+	maxIsa() = isa;
+}
+
+QString Threshold::isaName(Isa isa) {
+
+	switch (isa) {
+	case isa_avx2:	return "AVX2";
+	case isa_sse2:	return "SSE2";
+	default:		return "scalar";
+	}
+}
+
+cv::Mat Threshold::toGray(const cv::Mat& img) {
+
+	if (img.channels() == 1)
+		return img;
+
+	cv::Mat gImg;
+	if (img.channels() == 4)
+		cv::cvtColor(img, gImg, cv::COLOR_BGRA2GRAY);
+	else
+		cv::cvtColor(img, gImg, cv::COLOR_BGR2GRAY);
+
+	return gImg;
+}
+
+Threshold::Isa& Threshold::maxIsa() {
+	static Isa mi = isa_avx2;
+	return mi;
+}
+
+};
@@ -0,0 +1,86 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QString>
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Vectorized 8 bit histogram, Otsu threshold and threshold/pack kernels.
+/// The instruction set (AVX2, SSE2 or scalar) is chosen at runtime.
+/// The histogram uses SSE2 loads only (the bins are counted with scalar code).
+/// Histograms are accumulated in four sub-histograms so that consecutive
+/// equal pixels (e.g. background) do not stall on the same counter.
+/// otsu() is a drop-in replacement for rdf::IP::threshOtsu (same threshold as OpenCV).
+/// </summary>
+class DllRdmExport Threshold {
+
+public:
+	enum Isa {
+		isa_scalar = 0,
+		isa_sse2,
+		isa_avx2,
+
+		isa_end
+	};
+
+	static cv::Mat otsu(const cv::Mat& img, bool invert = true);
+
+	static void histogram(const cv::Mat& img, int* hist);
+	static int otsuThreshold(const int* hist);
+
+	static cv::Mat threshold(const cv::Mat& img, int thr, bool invert = true);
+	static cv::Mat thresholdPacked(const cv::Mat& img, int thr, bool invert = true);
+
+	static Isa isa();
+	static void setMaxIsa(Isa isa);
+	static QString isaName(Isa isa);
+
+private:
+	static cv::Mat toGray(const cv::Mat& img);
+	static Isa &maxIsa();
+};
+
+};
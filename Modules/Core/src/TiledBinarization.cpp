@@ -0,0 +1,179 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "TiledBinarization.h"
+
+// ReadFramework
+#include "Binarization.h"
+
+// ReadModules
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+TiledBinarization::TiledBinarization(const cv::Mat& img, const cv::Mat& mask) {
+	mImg = img;
+	mMask = mask;
+}
+
+void TiledBinarization::setTileSize(int tileSize) {
+	mTileSize = tileSize;
+}
+
+void TiledBinarization::setOverlap(int overlap) {
+	mOverlap = overlap;
+}
+
+void TiledBinarization::setCancel(const std::atomic<bool>* cancel) {
+	mCancel = cancel;
+}
+
+/// <summary>
+/// Binarizes the tiles in parallel.
+/// Images that fit into a single tile are binarized as a whole.
+/// </summary>
+/// <returns>false if the image is empty or the computation was cancelled</returns>
+bool TiledBinarization::compute() {
+
+	if (mImg.empty())
+		return false;
+
+	ScopedSpan span("binarization/tiled");
+
+	QVector<cv::Rect> tl = tiles(mImg.size(), mTileSize);
+	mBwImg.create(mImg.size(), CV_8UC1);
+
+	// Su's thresholds are computed in windows of about two stroke widths
+	if (mOverlap <= 0 && tl.size() > 1)
+		mOverlap = qBound(32, qRound(16 * strokeWidth(mImg)), qMax(mTileSize / 2, 32));
+
+	cv::Rect imgRect(cv::Point(), mImg.size());
+
+	cv::parallel_for_(cv::Range(0, tl.size()), [&](const cv::Range& range) {
+
+		for (int idx = range.start; idx < range.end; idx++) {
+
+			if (mCancel && *mCancel)
+				return;
+
+			const cv::Rect& inner = tl[idx];
+			cv::Rect outer(inner.x - mOverlap, inner.y - mOverlap, inner.width + 2 * mOverlap, inner.height + 2 * mOverlap);
+			outer &= imgRect;
+
+			// rdf expects continuous images
+			cv::Mat tImg = mImg(outer).clone();
+			cv::Mat tMask = mMask.empty() ? cv::Mat() : mMask(outer).clone();
+
+			rdf::BinarizationSuAdapted bin(tImg, tMask);
+			bin.compute();
+
+			cv::Mat tBw = bin.binaryImage();
+			tBw(inner - outer.tl()).copyTo(mBwImg(inner));
+		}
+	});
+
+	if (mCancel && *mCancel) {
+		mBwImg.release();
+		return false;
+	}
+
+	span.addBytes(mBwImg);
+
+	return true;
+}
+
+cv::Mat TiledBinarization::binaryImage() const {
+	return mBwImg;
+}
+
+/// <summary>
+/// Returns the overlap in px (derived in compute() if it was not set).
+/// </summary>
+int TiledBinarization::overlap() const {
+	return mOverlap;
+}
+
+/// <summary>
+/// Splits the image into tiles of (at most) tileSize x tileSize.
+/// </summary>
+QVector<cv::Rect> TiledBinarization::tiles(const cv::Size& size, int tileSize) {
+
+	QVector<cv::Rect> tl;
+
+	if (tileSize <= 0)
+		tileSize = qMax(size.width, size.height);
+
+	for (int y = 0; y < size.height; y += tileSize) {
+		for (int x = 0; x < size.width; x += tileSize) {
+			tl << cv::Rect(x, y, qMin(tileSize, size.width - x), qMin(tileSize, size.height - y));
+		}
+	}
+
+	return tl;
+}
+
+/// <summary>
+/// Estimates the mean stroke width (px) of dark text on bright background.
+/// The image is downscaled to at most 2048 px and thresholded (Otsu). The
+/// distances of a stroke's pixels to the background are spread evenly over
+/// [0, w/2], so the stroke width is about four times their mean.
+/// </summary>
+double TiledBinarization::strokeWidth(const cv::Mat& img) {
+
+	if (img.empty())
+		return 0.0;
+
+	cv::Mat gray = img;
+	if (img.channels() == 3)
+		cv::cvtColor(img, gray, cv::COLOR_BGR2GRAY);
+	else if (img.channels() == 4)
+		cv::cvtColor(img, gray, cv::COLOR_BGRA2GRAY);
+
+	double s = qMin(1.0, 2048.0 / qMax(gray.cols, gray.rows));
+	if (s < 1.0)
+		cv::resize(gray, gray, cv::Size(), s, s, cv::INTER_AREA);
+
+	cv::Mat fg, dist;
+	cv::threshold(gray, fg, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+	cv::distanceTransform(fg, dist, CV_DIST_L2, 3);
+
+	if (cv::countNonZero(fg) == 0)
+		return 0.0;
+
+	return 4.0 * cv::mean(dist, fg)[0] / s;
+}
+
+};
@@ -0,0 +1,90 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QVector>
+#include <opencv2/core/core.hpp>
+
+#include <atomic>
+#pragma warning(pop)		// no warnings from includes - end
+
+#ifndef DllRdmExport
+#ifdef DLL_RDM_EXPORT
+#define DllRdmExport Q_DECL_EXPORT
+#else
+#define DllRdmExport Q_DECL_IMPORT
+#endif
+#endif
+
+namespace rdm {
+
+/// <summary>
+/// Su binarization (rdf::BinarizationSuAdapted) of large images in parallel tiles.
+/// Each tile is binarized with a border of overlap pixels which is cropped
+/// before the tile is stitched into the result. The overlap has to be larger
+/// than Su's local window (a few stroke widths) so that tile borders do not show.
+/// If no overlap is set, it is derived from the stroke width (see strokeWidth()).
+/// NOTE: the result is not identical to the untiled binarization. The contrast
+/// threshold and the stroke width are estimated per tile, so tiles should be
+/// large enough to contain text. Tiling is therefore opt-in (Binarization/tiledMinMegaPixels).
+/// read-modules-bench --tiling checks the mismatches (at the tile seams and in
+/// the tile interiors) against the untiled binarization.
+/// </summary>
+class DllRdmExport TiledBinarization {
+
+public:
+	TiledBinarization(const cv::Mat& img = cv::Mat(), const cv::Mat& mask = cv::Mat());
+
+	void setTileSize(int tileSize);
+	void setOverlap(int overlap);
+	void setCancel(const std::atomic<bool>* cancel);
+
+	bool compute();
+	cv::Mat binaryImage() const;
+	int overlap() const;
+
+	static QVector<cv::Rect> tiles(const cv::Size& size, int tileSize);
+	static double strokeWidth(const cv::Mat& img);
+
+private:
+	cv::Mat mImg;
+	cv::Mat mMask;
+	cv::Mat mBwImg;
+
+	int mTileSize = 4096;
+	int mOverlap = 0;		// px - 0 derives it from the stroke width
+	const std::atomic<bool>* mCancel = 0;	// checked before each tile
+};
+
+};
@@ -44,6 +44,10 @@ related links:
 #include "PageParser.h"
 #include "Elements.h"
 
+// ReadModules
+#include "PageXmlCache.h"
+#include "Telemetry.h"
+
 #pragma warning(push, 0)	// no warnings from includes - begin
 #include <QAction>
 #include <QUuid>
@@ -154,6 +158,8 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 	if (!imgC)
 		return imgC;
 
+	TelemetryPage tp(imgC->filePath());
+
 	if(runID == mRunIDs[id_train]) {
 
 		QImage img = imgC->image();
@@ -181,9 +187,8 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 		QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(imgC->filePath());
 		//QString saveXmlPath = rdf::PageXmlParser::imagePathToXmlPath(imgC->filePath());
 
-		rdf::PageXmlParser parser;
-		parser.read(loadXmlPath);
-		auto pe = parser.page();
+		// not read-only: the table cells are modified below (setHeader)
+		auto pe = PageXmlCache::instance().read(loadXmlPath);
 
 		//read xml separators and store them to testinfo
 		QVector<rdf::Line> hLines;
@@ -304,6 +309,8 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 	}
 	else if (runID == mRunIDs[id_match]) {
 
+		ScopedSpan span("forms/apply");
+
 		//use for debugging - apply template
 		QImage img = imgC->image();
 		QImage result;
@@ -378,7 +385,10 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 			//rdf::Image::save(resultImg, "D:\\tmp\\alignedImg.png");
 
 			qDebug() << "Match template...";
-			formF.matchTemplate();
+			{
+				ScopedSpan ms("forms/matchTemplate");
+				formF.matchTemplate();
+			}
 
 			resultImg = formF.drawLinesNotUsedForm(drawImg);
 			cv::cvtColor(resultImg, resultImg, CV_BGR2RGBA);
@@ -426,9 +436,8 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 		QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(imgC->filePath());
 		QString saveXmlPath = rdf::PageXmlParser::imagePathToXmlPath(imgC->filePath());
 
-		rdf::PageXmlParser parser;
-		bool newXML = parser.read(loadXmlPath);
-		auto pe = parser.page();
+		bool newXML = false;
+		auto pe = PageXmlCache::instance().read(loadXmlPath, &newXML);
 
 		if (!newXML) {
 			//xml is newly created
@@ -444,7 +453,7 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 		formF.setSeparators(pe->rootRegion());
 
 		//save pageXml
-		parser.write(saveXmlPath, pe);
+		PageXmlCache::instance().write(saveXmlPath, pe);
 
 
 		//// ----------- use this one for batch processing-----------------------------------------
@@ -464,6 +473,8 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 	}
 	else if (runID == mRunIDs[id_evaluate]) {
 
+		ScopedSpan span("forms/evaluate");
+
 		//calculate match the same way as for table
 		//no debug images are created
 
@@ -522,7 +533,10 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 		cv::cvtColor(drawImg, drawImg, CV_RGBA2BGR);
 
 		qDebug() << "Match template...";
-		formF.matchTemplate();
+		{
+			ScopedSpan ms("forms/matchTemplate");
+			formF.matchTemplate();
+		}
 
 		drawImg = formF.drawMatchedForm(drawImg);
 		cv::cvtColor(drawImg, drawImg, CV_BGR2RGBA);
@@ -590,9 +604,8 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 		
 		QString saveXmlPath = rdf::PageXmlParser::imagePathToXmlPath(finalXmlPath.absoluteFilePath());
 		
-		rdf::PageXmlParser parser;
-		bool newXML = parser.read(loadXmlPath);
-		auto pe = parser.page();
+		bool newXML = false;
+		auto pe = PageXmlCache::instance().read(loadXmlPath, &newXML);
 
 		if (!newXML) {
 			//xml is newly created
@@ -608,7 +621,7 @@ QSharedPointer<nmc::DkImageContainer> FormsAnalysis::runPlugin(
 		formF.setSeparators(pe->rootRegion());
 
 		//save pageXml
-		parser.write(saveXmlPath, pe);
+		PageXmlCache::instance().write(saveXmlPath, pe);
 	}
 
 	// wrong runID? - do nothing
@@ -629,6 +642,12 @@ void FormsAnalysis::preLoadPlugin() const {
 }
 
 void FormsAnalysis::postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo>>& batchInfo) const {
+
+	Telemetry::instance().flush();
+
+	if (batchInfo.empty())
+		return;
+
 	int runIdx = mRunIDs.indexOf(batchInfo.first()->id());
 
 
@@ -53,6 +53,11 @@ related links:
 
 #include "LayoutAnalysis.h"
 
+// ReadModules
+#include "PageXmlCache.h"
+#include "ImageBridge.h"
+#include "BinaryCache.h"
+#include "Telemetry.h"
 
 // nomacs
 #include "DkImageStorage.h"
@@ -145,6 +150,7 @@ LayoutPlugin::~LayoutPlugin() {
 void LayoutPlugin::postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo> >& batchInfo) const {
 
 	rdf::Config::instance().save();
+	Telemetry::instance().flush();
 
 	if (batchInfo.empty())
 		return;
@@ -290,13 +296,13 @@ QSharedPointer<nmc::DkImageContainer> LayoutPlugin::runPlugin(
 	if (!imgC)
 		return imgC;
 
+	TelemetryPage tp(imgC->filePath());
+
 	// load suplemental XML
 	QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.inputFilePath());
-	rdf::PageXmlParser parser;
-	parser.read(loadXmlPath);
+	auto xmlPage = PageXmlCache::instance().read(loadXmlPath);
 
 	// set our header info
-	auto xmlPage = parser.page();
 	xmlPage->setCreator(QString("CVL"));
 	xmlPage->setImageSize(QSize(imgC->image().size()));
 	xmlPage->setImageFileName(imgC->fileName());
@@ -304,11 +310,11 @@ QSharedPointer<nmc::DkImageContainer> LayoutPlugin::runPlugin(
 
 	if(runID == mRunIDs[id_layout]) {
 
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
-		imgCv = compute(imgCv, parser);
+		MatView imgCv(imgC->image());
+		cv::Mat rImg = compute(imgCv, xmlPage);
 
 		if (mConfig.drawResults()) {
-			QImage img = nmc::DkImage::mat2QImage(imgCv);
+			QImage img = ImageBridge::toQImage(rImg);
 			imgC->setImage(img, tr("Layout Analysis Visualized"));
 		}
 	}
@@ -335,10 +341,12 @@ QSharedPointer<nmc::DkImageContainer> LayoutPlugin::runPlugin(
 			QSharedPointer<rdf::SeparatorRegion> pSepR(new rdf::SeparatorRegion());
 			pSepR->setLine(alllines[i].qLine());
 
-			parser.page()->rootRegion()->addUniqueChild(pSepR);
+			xmlPage->rootRegion()->addUniqueChild(pSepR);
 		}
 
-		parser.write(saveXmlPath, parser.page());
+		// the XML is written below if saveXml is true
+		if (!mConfig.saveXml())
+			PageXmlCache::instance().write(saveXmlPath, xmlPage);
 
 		// visualize
 		if (mConfig.drawResults()) {
@@ -347,19 +355,19 @@ QSharedPointer<nmc::DkImageContainer> LayoutPlugin::runPlugin(
 			if (synLine.channels() == 1)
 				cv::cvtColor(synLine, synLine, CV_GRAY2BGRA);
 
-			QImage img = nmc::DkImage::mat2QImage(synLine);
+			QImage img = ImageBridge::toQImage(synLine);
 			imgC->setImage(img, tr("Lines Detected"));
 		}
 	}
 	else if (runID == mRunIDs[id_layout_collect_features]) {
 
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
+		MatView imgCv(imgC->image());
 		
 		QSharedPointer<FeatureCollectionInfo> layoutInfo(new FeatureCollectionInfo(runID, imgC->filePath()));
-		imgCv = collectFeatures(imgCv, parser, layoutInfo);
+		cv::Mat rImg = collectFeatures(imgCv, xmlPage, layoutInfo);
 		
 		if (mConfig.drawResults()) {
-			QImage img = nmc::DkImage::mat2QImage(imgCv);
+			QImage img = ImageBridge::toQImage(rImg);
 			imgC->setImage(img, tr("Groundtruth Features"));
 		}
 
@@ -368,16 +376,15 @@ QSharedPointer<nmc::DkImageContainer> LayoutPlugin::runPlugin(
 	else if (runID == mRunIDs[id_layout_classify]) {
 
 		QString gtXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.inputFilePath(), "gt");
-		rdf::PageXmlParser pgt;
-		pgt.read(gtXmlPath);
+		auto gtPage = PageXmlCache::instance().read(gtXmlPath, 0, true);
 
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
+		MatView imgCv(imgC->image());
 
 		QSharedPointer<StatsInfo> statsInfo(new StatsInfo(runID, imgC->filePath()));
-		imgCv = classifyRegions(imgCv, pgt, statsInfo);
+		cv::Mat rImg = classifyRegions(imgCv, gtPage, statsInfo);
 
 		if (mConfig.drawResults()) {
-			QImage img = nmc::DkImage::mat2QImage(imgCv);
+			QImage img = ImageBridge::toQImage(rImg);
 			imgC->setImage(img, tr("Classified Regions"));
 		}
 
@@ -392,20 +399,20 @@ QSharedPointer<nmc::DkImageContainer> LayoutPlugin::runPlugin(
 			saveXmlPath = rdf::Utils::createFilePath(rdf::PageXmlParser::imagePathToXmlPath(imgC->filePath()), "-results");
 		}
 		
-		parser.write(saveXmlPath, parser.page());
+		PageXmlCache::instance().write(saveXmlPath, xmlPage);
 	}
 
 	// wrong runID? - do nothing
 	return imgC;
 }
 
-cv::Mat LayoutPlugin::compute(const cv::Mat & src, rdf::PageXmlParser & parser) const {
+cv::Mat LayoutPlugin::compute(const cv::Mat & src, QSharedPointer<rdf::PageElement>& pe) const {
 
 
 	rdf::Timer dt;
+	ScopedSpan span("layout/compute");
 
 	cv::Mat img = src.clone();
-	auto pe = parser.page();
 
 	// compute layout analysis
 	rdf::LayoutAnalysis la(img);
@@ -454,10 +461,9 @@ cv::Mat LayoutPlugin::compute(const cv::Mat & src, rdf::PageXmlParser & parser)
 	return src;
 }
 
-cv::Mat LayoutPlugin::computePageSegmentation(const cv::Mat & src, const rdf::PageXmlParser & parser) const {
+cv::Mat LayoutPlugin::computePageSegmentation(const cv::Mat & src, const QSharedPointer<rdf::PageElement>& pe) const {
 	
 	// if available, get informaton from existing xmls
-	auto pe = parser.page();
 	QVector<QSharedPointer<rdf::Region> > separators = rdf::Region::filter(pe->rootRegion().data(), rdf::Region::type_separator);
 	QVector<rdf::Line> separatingLines;
 	for (auto s : separators) {
@@ -533,9 +539,10 @@ cv::Mat LayoutPlugin::computePageSegmentation(const cv::Mat & src, const rdf::Pa
 	return rImg;
 }
 
-cv::Mat LayoutPlugin::collectFeatures(const cv::Mat & src, const rdf::PageXmlParser & parser, QSharedPointer<FeatureCollectionInfo>& layoutInfo) const {
+cv::Mat LayoutPlugin::collectFeatures(const cv::Mat & src, const QSharedPointer<rdf::PageElement>& pe, QSharedPointer<FeatureCollectionInfo>& layoutInfo) const {
 
 	rdf::Timer dt;
+	ScopedSpan span("layout/collectFeatures");
 
 	// test loading of label lookup
 	rdf::LabelManager lm = rdf::LabelManager::read(mSplConfig.labelConfigFilePath());
@@ -553,8 +560,8 @@ cv::Mat LayoutPlugin::collectFeatures(const cv::Mat & src, const rdf::PageXmlPar
 	spl.setFilePath(layoutInfo->filePath());	// parse filepath for gt
 	
 	// set the ground truth
-	if (parser.page())
-		spl.setRootRegion(parser.page()->rootRegion());
+	if (pe)
+		spl.setRootRegion(pe->rootRegion());
 
 	if (!spl.compute())
 		qCritical() << "could not compute SuperPixel labeling!";
@@ -576,11 +583,10 @@ cv::Mat LayoutPlugin::collectFeatures(const cv::Mat & src, const rdf::PageXmlPar
 	return src;
 }
 
-cv::Mat LayoutPlugin::classifyRegions(const cv::Mat & src, const rdf::PageXmlParser & parser, QSharedPointer<StatsInfo>& statsInfo) const {
+cv::Mat LayoutPlugin::classifyRegions(const cv::Mat & src, const QSharedPointer<rdf::PageElement>& pe, QSharedPointer<StatsInfo>& statsInfo) const {
 
 	rdf::Timer dt;
-	
-	auto pe = parser.page();
+	ScopedSpan span("layout/classifyRegions");
 
 	// -------------------------------------------------------------------- Generate Super Pixels 
 	rdf::ScaleSpaceSuperPixel<rdf::SuperPixel> gpm(src);
@@ -599,8 +605,8 @@ cv::Mat LayoutPlugin::classifyRegions(const cv::Mat & src, const rdf::PageXmlPar
 	spl.setFilePath(statsInfo->filePath());	// parse filepath for gt
 
 	// set the ground truth
-	if (parser.page())
-		spl.setRootRegion(parser.page()->rootRegion());
+	if (pe)
+		spl.setRootRegion(pe->rootRegion());
 
 	if (!spl.compute())
 		qCritical() << "could not compute SuperPixel labeling!";
@@ -657,7 +663,21 @@ cv::Mat LayoutPlugin::classifyRegions(const cv::Mat & src, const rdf::PageXmlPar
 
 rdf::LineTrace LayoutPlugin::computeLines(QSharedPointer<nmc::DkImageContainer> imgC) const {
 	
+	ScopedSpan span("layout/lines");
+
+	// packed binary images (e.g. from the binarization plugin) are not binarized again
+	if (ImageBridge::isBinary(imgC->image())) {
+
+		cv::Mat bwImg = ImageBridge::toBinary(imgC->image());
+		rdf::LineTrace lt(bwImg, cv::Mat());
+		lt.setAngle(0.0);
+		lt.compute();
+
+		return lt;
+	}
+
 	cv::Mat imgCv = nmc::DkImage::qImage2Mat(imgC->image());
+	cv::Mat keyImg = imgCv;
 
 	if (imgCv.depth() != CV_8U) {
 		imgCv.convertTo(imgCv, CV_8U, 255);
@@ -682,9 +702,12 @@ rdf::LineTrace LayoutPlugin::computeLines(QSharedPointer<nmc::DkImageContainer>
 	//skewAngle = skewAngle / 180.0 * CV_PI; //check if minus angle is needed....
 	double skewAngle = 0.0f;
 
-	rdf::BinarizationSuAdapted binarizeImg(imgCv, mask);
-	binarizeImg.compute();
-	cv::Mat bwImg = binarizeImg.binaryImage();
+	// the binarization plugin (or a former run) might have computed it already
+	cv::Mat bwImg = BinaryCache::instance().get(keyImg, BinaryCache::su(), [&]() {
+		rdf::BinarizationSuAdapted binarizeImg(imgCv, mask);
+		binarizeImg.compute();
+		return binarizeImg.binaryImage();
+	});
 
 	rdf::LineTrace lt(bwImg, mask);
 
@@ -52,7 +52,7 @@ namespace cv {
 
 namespace rdf {
 	class LineTrace;
-	class PageXmlParser;
+	class PageElement;
 }
 
 namespace rdm {
@@ -178,10 +178,10 @@ protected:
 	LayoutConfig mConfig;
 
 	// layout plugin functions
-	cv::Mat compute(const cv::Mat& src, rdf::PageXmlParser& parser) const;
-	cv::Mat computePageSegmentation(const cv::Mat& src, const rdf::PageXmlParser& parser) const;
-	cv::Mat collectFeatures(const cv::Mat& src, const rdf::PageXmlParser& parser, QSharedPointer<FeatureCollectionInfo>& layoutInfo) const;
-	cv::Mat classifyRegions(const cv::Mat& src, const rdf::PageXmlParser& parser, QSharedPointer<StatsInfo>& statsInfo) const;
+	cv::Mat compute(const cv::Mat& src, QSharedPointer<rdf::PageElement>& page) const;
+	cv::Mat computePageSegmentation(const cv::Mat& src, const QSharedPointer<rdf::PageElement>& page) const;
+	cv::Mat collectFeatures(const cv::Mat& src, const QSharedPointer<rdf::PageElement>& page, QSharedPointer<FeatureCollectionInfo>& layoutInfo) const;
+	cv::Mat classifyRegions(const cv::Mat& src, const QSharedPointer<rdf::PageElement>& page, QSharedPointer<StatsInfo>& statsInfo) const;
 	rdf::LineTrace computeLines(QSharedPointer<nmc::DkImageContainer> imgC) const;
 	bool train() const;
 };
@@ -38,6 +38,9 @@ related links:
 #include "Elements.h"
 #include "ElementsHelper.h"
 
+// ReadModules
+#include "PageXmlCache.h"
+
 // nomacs
 #include "DkImageStorage.h"
 #include "DkSettings.h"
@@ -216,12 +219,10 @@ QSharedPointer<nmc::DkImageContainer> PageXmlPlugin::runPlugin(
 
 	// load suplemental XML
 	QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.inputFilePath());
-	rdf::PageXmlParser parser;
-	parser.read(loadXmlPath);
 
 	if (runID == mRunIDs[id_page_filter]) {
 		// set our header info
-		auto xmlPage = parser.page();
+		auto xmlPage = PageXmlCache::instance().read(loadXmlPath);
 		xmlPage->setCreator(QString("CVL"));
 		xmlPage->setImageSize(QSize(imgC->image().size()));
 		xmlPage->setImageFileName(imgC->fileName());
@@ -233,7 +234,7 @@ QSharedPointer<nmc::DkImageContainer> PageXmlPlugin::runPlugin(
 
 		// save xml
 		QString saveXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.outputFilePath());
-		parser.write(saveXmlPath, parser.page());
+		PageXmlCache::instance().write(saveXmlPath, xmlPage);
 	}
 	else if (runID == mRunIDs[id_page_drawer]) {
 
@@ -243,15 +244,19 @@ QSharedPointer<nmc::DkImageContainer> PageXmlPlugin::runPlugin(
 		QPainter painter(&img);
 		painter.setRenderHints(QPainter::Antialiasing);
 
-		const auto pd = parser.page();
-		if (parser.page() && !parser.page()->isEmpty())
-			rdf::RegionManager::instance().drawRegion(painter, parser.page()->rootRegion(), mConfig.xmlConfig());
+		const auto pd = PageXmlCache::instance().read(loadXmlPath, 0, true);
+		if (pd && !pd->isEmpty())
+			rdf::RegionManager::instance().drawRegion(painter, pd->rootRegion(), mConfig.xmlConfig());
 
 		imgC->setImage(img, tr("PAGE Attributes"));
 	}
 	else if (runID == mRunIDs[id_page_validator]) {
 
 		QSharedPointer<PageXmlInfo> xmlInfo(new PageXmlInfo(runID, imgC->filePath()));
+
+		// the validator needs the parser's status - so we don't use the cache here
+		rdf::PageXmlParser parser;
+		parser.read(loadXmlPath);
 		
 		// if everything is fine - check if the dimensions are there...
 		if (parser.loadStatus() == rdf::PageXmlParser::status_ok) {
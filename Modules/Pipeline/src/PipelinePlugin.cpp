@@ -0,0 +1,519 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "PipelinePlugin.h"
+
+// ReadFramework
+#include "Settings.h"
+#include "Binarization.h"
+#include "Algorithms.h"
+#include "ImageProcessor.h"
+#include "PageParser.h"
+#include "Elements.h"
+#include "Utils.h"
+
+// ReadModules
+#include "PageXmlCache.h"
+#include "ImageBridge.h"
+#include "BinaryCache.h"
+#include "Rotation.h"
+#include "Telemetry.h"
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QAction>
+#include <QFileInfo>
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+/**
+*	Constructor
+**/
+PipelinePlugin::PipelinePlugin(QObject* parent) : QObject(parent) {
+
+	// create run IDs
+	QVector<QString> runIds;
+	runIds.resize(id_end);
+
+	runIds[id_pipeline] = "e9a07aee9b924e7cb2e6906d3b3e95ea";
+	mRunIDs = runIds.toList();
+
+	// create menu actions
+	QVector<QString> menuNames;
+	menuNames.resize(id_end);
+
+	menuNames[id_pipeline] = tr("Run Document Pipeline");
+	mMenuNames = menuNames.toList();
+
+	// create menu status tips
+	QVector<QString> statusTips;
+	statusTips.resize(id_end);
+
+	statusTips[id_pipeline] = tr("Binarizes, deskews, analyzes the layout and recognizes the text in a single pass");
+	mMenuStatusTips = statusTips.toList();
+
+	// saved default settings
+	rdf::DefaultSettings s;
+	s.beginGroup(name());
+
+	mConfig.saveDefaultSettings(s);
+
+	rdf::BaseSkewEstimationConfig bsec;
+	bsec.saveDefaultSettings(s);
+
+	rdf::LayoutAnalysisConfig lac;
+	lac.saveDefaultSettings(s);
+
+	rdf::ScaleFactoryConfig sfc;
+	sfc.saveDefaultSettings(s);
+
+#ifdef WITH_TESSERACT
+	TesseractPluginConfig tc;
+	tc.saveDefaultSettings(s);
+#endif
+
+	s.endGroup();
+}
+/**
+*	Destructor
+**/
+PipelinePlugin::~PipelinePlugin() {
+}
+
+/**
+* Returns descriptive iamge for every ID
+* @param plugin ID
+**/
+QImage PipelinePlugin::image() const {
+
+	return QImage(":/Pipeline/img/read.png");
+}
+
+QList<QAction*> PipelinePlugin::createActions(QWidget* parent) {
+
+	if (mActions.empty()) {
+
+		for (int idx = 0; idx < id_end; idx++) {
+			QAction* ca = new QAction(mMenuNames[idx], parent);
+			ca->setObjectName(mMenuNames[idx]);
+			ca->setStatusTip(mMenuStatusTips[idx]);
+			ca->setData(mRunIDs[idx]);	// runID needed for calling function runPlugin()
+			mActions.append(ca);
+		}
+	}
+
+	return mActions;
+}
+
+QList<QAction*> PipelinePlugin::pluginActions() const {
+	return mActions;
+}
+
+/**
+* Runs all stages that are enabled in the settings.
+* The image, the skew angle and the PAGE tree are passed between
+* the stages in memory, the PAGE XML is written once when all stages
+* are done. The binary image is used by the OCR and the output image
+* only: rdf's skew estimation and layout analysis have no binary
+* input and preprocess the (deskewed) gray image themselves.
+* @param plugin ID
+* @param image to be processed
+**/
+QSharedPointer<nmc::DkImageContainer> PipelinePlugin::runPlugin(
+	const QString & runID, 
+	QSharedPointer<nmc::DkImageContainer> imgC, 
+	const nmc::DkSaveInfo & saveInfo, 
+	QSharedPointer<nmc::DkBatchInfo>& batchInfo) const {
+
+	if (!imgC || runID != mRunIDs[id_pipeline])
+		return imgC;
+
+	QSharedPointer<PipelineInfo> info(new PipelineInfo(runID, imgC->filePath()));
+	batchInfo = info;
+
+	rdf::Timer dt;
+	TelemetryPage tp(imgC->filePath());
+
+	// the view must live as long as the stages work on the input
+	MatView imgView(imgC->image());
+
+	PipelinePage pp;
+	pp.img = imgView;
+
+	// load existing XML or create new one
+	QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.inputFilePath());
+	pp.page = PageXmlCache::instance().read(loadXmlPath);
+	pp.page->setCreator(QString("CVL"));
+	pp.page->setImageFileName(imgC->fileName());
+	pp.xmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.outputFilePath());
+
+	if (mConfig.binarize()) {
+		ScopedSpan span("pipeline/binarize");
+		binarize(pp);
+		span.addBytes(pp.bwImg);
+		info->setStageTime(PipelineInfo::stage_binarize, span.elapsed());
+	}
+
+	if (mConfig.deskew()) {
+		ScopedSpan span("pipeline/deskew");
+		deskew(pp);
+		info->setStageTime(PipelineInfo::stage_deskew, span.elapsed());
+		info->setSkewAngle(pp.angle);
+	}
+
+	// the regions refer to the deskewed image
+	pp.page->setImageSize(QSize(pp.img.cols, pp.img.rows));
+
+	if (mConfig.layout()) {
+		ScopedSpan span("pipeline/layout");
+		layout(pp);
+		info->setStageTime(PipelineInfo::stage_layout, span.elapsed());
+	}
+
+	if (mConfig.ocr()) {
+		ScopedSpan span("pipeline/ocr");
+		ocr(pp);
+		info->setStageTime(PipelineInfo::stage_ocr, span.elapsed());
+	}
+
+	PageXmlCache::instance().write(pp.xmlPath, pp.page);
+
+	if (mConfig.outputImage() == PipelineConfig::output_binary && !pp.bwImg.empty())
+		imgC->setImage(ImageBridge::toQImage(pp.bwImg), tr("Binarized"));
+	else if (pp.rotated) {
+
+		// the PAGE coordinates refer to the deskewed image - saving the input would break them
+		if (mConfig.outputImage() == PipelineConfig::output_input)
+			qWarning() << "[Pipeline]" << imgC->fileName() << "is deskewed, saving the skew corrected image instead of the input";
+
+		imgC->setImage(ImageBridge::toQImage(pp.img), tr("Skew corrected"));
+	}
+
+	qInfo() << "[Pipeline]" << imgC->fileName() << "processed in" << dt;
+
+	return imgC;
+}
+
+void PipelinePlugin::binarize(PipelinePage& pp) const {
+
+	// shares results with the binarization & layout plugins (if the binary cache is enabled)
+	BinaryCache& bc = BinaryCache::instance();
+
+	if (mConfig.estimateMask()) {
+		cv::Mat mask = bc.get(pp.img, BinaryCache::mask(), [&]() { return rdf::IP::estimateMask(pp.img); });
+		pp.bwImg = bc.get(pp.img, BinaryCache::su(true), [&]() {
+			rdf::BinarizationSuAdapted bin(pp.img, mask);
+			bin.compute();
+			return bin.binaryImage();
+		});
+	}
+	else {
+		pp.bwImg = bc.get(pp.img, BinaryCache::su(), [&]() {
+			rdf::BinarizationSuAdapted bin(pp.img);
+			bin.compute();
+			return bin.binaryImage();
+		});
+	}
+}
+
+void PipelinePlugin::deskew(PipelinePage& pp) const {
+
+	rdf::BaseSkewEstimation bse;
+	bse.setImages(pp.img);
+	bse.setFixedThr(false);
+
+	QSharedPointer<rdf::BaseSkewEstimationConfig> cf = bse.config();
+	*cf = mBseConfig;
+
+	if (!bse.compute()) {
+		qWarning() << "[Pipeline] could not compute skew";
+		return;
+	}
+
+	pp.angle = -bse.getAngle() / 180.0 * CV_PI;
+
+	if (pp.angle == 0.0)
+		return;
+
+	// regions of an existing PAGE XML refer to the input image - keep its frame
+	if (!pp.page->rootRegion()->children().empty()) {
+		qInfo() << "[Pipeline] the PAGE XML has regions - the image is not deskewed";
+		return;
+	}
+
+	pp.img = Rotation(pp.angle).rotate(pp.img);
+
+	if (!pp.bwImg.empty()) {
+		// nearest neighbor keeps the image binary
+		Rotation r(pp.angle, Rotation::interp_nearest);
+		r.setBorderValue(0);
+		pp.bwImg = r.rotate(pp.bwImg);
+	}
+
+	pp.rotated = true;
+}
+
+void PipelinePlugin::layout(PipelinePage& pp) const {
+
+	// NOTE: rdf::LayoutAnalysis computes its super pixels on the gray image (pp.bwImg is not used)
+
+	rdf::LayoutAnalysis la(pp.img);
+	la.setConfig(QSharedPointer<rdf::LayoutAnalysisConfig>(new rdf::LayoutAnalysisConfig(mLAConfig)));
+
+	auto sf = la.scaleFactory();
+	sf->setConfig(QSharedPointer<rdf::ScaleFactoryConfig>(new rdf::ScaleFactoryConfig(mSfConfig)));
+	la.setRootRegion(pp.page->rootRegion());
+
+	if (!la.compute())
+		qWarning() << "[Pipeline] could not compute layout analysis";
+
+	auto root = la.textBlockSet().toTextRegion();
+	for (const QSharedPointer<rdf::Region>& r : root->children()) {
+
+		if (!pp.page->rootRegion()->reassignChild(r))
+			pp.page->rootRegion()->addUniqueChild(r, true);	// true -> update
+	}
+
+	// write stop lines
+	auto seps = la.stopLines();
+	for (auto s : seps) {
+
+		QSharedPointer<rdf::SeparatorRegion> sp(new rdf::SeparatorRegion(s));
+		pp.page->rootRegion()->addUniqueChild(sp, true);
+	}
+}
+
+void PipelinePlugin::ocr(PipelinePage& pp) const {
+
+#ifdef WITH_TESSERACT
+	// reuse the binarization - tesseract expects dark text on bright background
+	cv::Mat ocrImg;
+	if (!pp.bwImg.empty())
+		cv::bitwise_not(pp.bwImg, ocrImg);
+	else
+		ocrImg = pp.img;
+
+	QImage img = TesseractEngine::normalizeImage(ImageBridge::toQImage(ocrImg), mTessConfig.inputFormat());
+
+	// OCR the text regions found by the layout analysis (or the whole page if there are none)
+	QVector<QSharedPointer<rdf::Region>> textRegions = TesseractEngine::extractTextRegions(pp.page);
+
+	if (textRegions.empty()) {
+
+		QSharedPointer<TesseractEngine> engine = TesseractEnginePool::instance().acquire(mTessConfig);
+
+		if (!engine)
+			return;
+
+		tesseract::ResultIterator* ri = engine->processPage(img);
+
+		if (ri) {
+			TesseractPageConverter converter(mTessConfig.textLevel(), mTessConfig.singleLevelOutput());
+			converter.setConfidences(mTessConfig.confidences());
+			converter.convert(ri, pp.page);
+			delete ri;
+		}
+	}
+	else {
+
+		QSharedPointer<TesseractResultCache> cache;
+		if (mTessConfig.resultCache() && !pp.xmlPath.isEmpty())
+			cache = TesseractResultCache::forCollection(QFileInfo(pp.xmlPath).absolutePath());
+
+		TesseractEngine::routeTextRegions(img, pp.page, textRegions, mTessConfig, cache);
+	}
+#else
+	Q_UNUSED(pp);
+	qWarning() << "[Pipeline] OCR is not available - the plugin was built without tesseract";
+#endif
+}
+
+void PipelinePlugin::postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo> > & batchInfo) const {
+
+	Telemetry::instance().flush();
+
+	QVector<double> times(PipelineInfo::stage_end, 0.0);
+	int numPages = 0;
+
+	for (auto bi : batchInfo) {
+
+		auto pi = qSharedPointerDynamicCast<PipelineInfo>(bi);
+
+		if (!pi)
+			continue;
+
+		for (int idx = 0; idx < PipelineInfo::stage_end; idx++)
+			times[idx] += pi->stageTime((PipelineInfo::Stage)idx);
+
+		numPages++;
+	}
+
+	if (numPages == 0)
+		return;
+
+	for (int idx = 0; idx < PipelineInfo::stage_end; idx++) {
+		qInfo().noquote() << "[Pipeline]" << PipelineInfo::stageName((PipelineInfo::Stage)idx) 
+			<< QString::number(times[idx] / numPages, 'f', 1) << "ms per page";
+	}
+}
+
+QString PipelinePlugin::settingsFilePath() const {
+	return rdf::Config::instance().settingsFilePath();
+}
+
+void PipelinePlugin::saveSettings(QSettings & settings) const {
+
+	settings.beginGroup(name());
+	mConfig.saveSettings(settings);
+	mBseConfig.saveSettings(settings);
+	mLAConfig.saveSettings(settings);
+	mSfConfig.saveSettings(settings);
+#ifdef WITH_TESSERACT
+	mTessConfig.saveSettings(settings);
+#endif
+	settings.endGroup();
+}
+
+void PipelinePlugin::loadSettings(QSettings & settings) {
+
+	settings.beginGroup(name());
+	mConfig.loadSettings(settings);
+	mBseConfig.loadSettings(settings);
+	mLAConfig.loadSettings(settings);
+	mSfConfig.loadSettings(settings);
+#ifdef WITH_TESSERACT
+	mTessConfig.loadSettings(settings);
+#endif
+	settings.endGroup();
+}
+
+QString PipelinePlugin::name() const {
+	return "PipelinePlugin";
+}
+
+// PipelineInfo --------------------------------------------------------------------
+PipelineInfo::PipelineInfo(const QString & id, const QString & filePath) : DkBatchInfo(id, filePath) {
+	mStageTimes.resize(stage_end);
+	mStageTimes.fill(0.0);
+}
+
+void PipelineInfo::setSkewAngle(double angle) {
+	mSkewAngle = angle;
+}
+
+double PipelineInfo::skewAngle() const {
+	return mSkewAngle;
+}
+
+void PipelineInfo::setStageTime(Stage stage, double ms) {
+	mStageTimes[stage] = ms;
+}
+
+double PipelineInfo::stageTime(Stage stage) const {
+	return mStageTimes[stage];
+}
+
+QString PipelineInfo::stageName(Stage stage) {
+
+	switch (stage) {
+	case stage_binarize:	return "binarization";
+	case stage_deskew:		return "skew correction";
+	case stage_layout:		return "layout analysis";
+	case stage_ocr:			return "OCR";
+	}
+
+	return "unknown";
+}
+
+// PipelineConfig --------------------------------------------------------------------
+PipelineConfig::PipelineConfig() : ModuleConfig("Pipeline") {
+}
+
+QString PipelineConfig::toString() const {
+
+	QString msg = rdf::ModuleConfig::toString();
+	msg += binarize() ? " binarize" : "";
+	msg += estimateMask() ? " (with mask)" : "";
+	msg += deskew() ? " deskew" : "";
+	msg += layout() ? " layout" : "";
+	msg += ocr() ? " OCR" : "";
+	msg += " output image: " + QString::number(mOutputImage);
+
+	return msg;
+}
+
+bool PipelineConfig::binarize() const {
+	return mBinarize;
+}
+
+bool PipelineConfig::estimateMask() const {
+	return mEstimateMask;
+}
+
+bool PipelineConfig::deskew() const {
+	return mDeskew;
+}
+
+bool PipelineConfig::layout() const {
+	return mLayout;
+}
+
+bool PipelineConfig::ocr() const {
+	return mOcr;
+}
+
+int PipelineConfig::outputImage() const {
+	return mOutputImage;
+}
+
+void PipelineConfig::load(const QSettings & settings) {
+
+	mBinarize		= settings.value("binarize", mBinarize).toBool();
+	mEstimateMask	= settings.value("estimateMask", mEstimateMask).toBool();
+	mDeskew			= settings.value("deskew", mDeskew).toBool();
+	mLayout			= settings.value("layout", mLayout).toBool();
+	mOcr			= settings.value("ocr", mOcr).toBool();
+	mOutputImage	= settings.value("outputImage", mOutputImage).toInt();
+}
+
+void PipelineConfig::save(QSettings & settings) const {
+
+	settings.setValue("binarize", mBinarize);
+	settings.setValue("estimateMask", mEstimateMask);
+	settings.setValue("deskew", mDeskew);
+	settings.setValue("layout", mLayout);
+	settings.setValue("ocr", mOcr);
+	settings.setValue("outputImage", mOutputImage);
+}
+
+};
@@ -0,0 +1,190 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+#include "DkPluginInterface.h"
+#include "DkBatchInfo.h"
+
+// ReadFramework
+#include "BaseModule.h"
+#include "SkewEstimation.h"
+#include "LayoutAnalysis.h"
+#include "ScaleFactory.h"
+
+#ifdef WITH_TESSERACT
+#include "TesseractEngine.h"
+#endif
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <opencv2/core/core.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdf {
+	class PageElement;
+}
+
+namespace rdm {
+
+class PipelineConfig : public rdf::ModuleConfig {
+
+public:
+	PipelineConfig();
+
+	virtual QString toString() const override;
+
+	enum OutputImage {
+		output_input = 0,
+		output_deskewed,
+		output_binary,
+
+		output_end
+	};
+
+	bool binarize() const;
+	bool estimateMask() const;
+	bool deskew() const;
+	bool layout() const;
+	bool ocr() const;
+	int outputImage() const;
+
+protected:
+	bool mBinarize = true;
+	bool mEstimateMask = false;
+	bool mDeskew = true;
+	bool mLayout = true;
+	bool mOcr = true;
+	int mOutputImage = output_deskewed;
+
+	void load(const QSettings& settings) override;
+	void save(QSettings& settings) const override;
+};
+
+class PipelineInfo : public nmc::DkBatchInfo {
+
+public:
+	PipelineInfo(const QString& id = QString(), const QString& filePath = QString());
+
+	enum Stage {
+		stage_binarize = 0,
+		stage_deskew,
+		stage_layout,
+		stage_ocr,
+
+		stage_end
+	};
+
+	void setSkewAngle(double angle);
+	double skewAngle() const;
+
+	void setStageTime(Stage stage, double ms);
+	double stageTime(Stage stage) const;
+
+	static QString stageName(Stage stage);
+
+private:
+	double mSkewAngle = 0.0;
+	QVector<double> mStageTimes;
+};
+
+/// <summary>
+/// Everything the pipeline's stages hand over to each other.
+/// </summary>
+class PipelinePage {
+
+public:
+	cv::Mat img;		// the (deskewed) input image
+	cv::Mat bwImg;		// binary image (text is white)
+	double angle = 0.0;	// skew angle in rad
+	bool rotated = false;	// true if img & bwImg were deskewed
+	QSharedPointer<rdf::PageElement> page;
+	QString xmlPath;	// output PAGE file
+};
+
+class PipelinePlugin : public QObject, nmc::DkBatchPluginInterface {
+	Q_OBJECT
+		Q_INTERFACES(nmc::DkBatchPluginInterface)
+		Q_PLUGIN_METADATA(IID "com.nomacs.ImageLounge.PipelinePlugin/3.0" FILE "PipelinePlugin.json")
+
+public:
+	PipelinePlugin(QObject* parent = 0);
+	~PipelinePlugin();
+
+	QImage image() const override;
+
+	QList<QAction*> createActions(QWidget* parent) override;
+	QList<QAction*> pluginActions() const override;
+	QSharedPointer<nmc::DkImageContainer> runPlugin(
+		const QString &runID, 
+		QSharedPointer<nmc::DkImageContainer> imgC, 
+		const nmc::DkSaveInfo& saveInfo,
+		QSharedPointer<nmc::DkBatchInfo>& batchInfo) const override;
+
+	virtual void preLoadPlugin() const override {};
+	virtual void postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo> > & batchInfo) const override;
+	
+	// settings
+	virtual QString settingsFilePath() const override;
+	virtual void saveSettings(QSettings& settings) const override;
+	virtual void loadSettings(QSettings& settings) override;
+	virtual QString name() const override;
+
+	enum {
+		id_pipeline,
+		// add actions here
+
+		id_end
+	};
+
+protected:
+	QList<QAction*> mActions;
+	QStringList mRunIDs;
+	QStringList mMenuNames;
+	QStringList mMenuStatusTips;
+
+	PipelineConfig mConfig;
+	rdf::BaseSkewEstimationConfig mBseConfig;
+	rdf::LayoutAnalysisConfig mLAConfig;
+	rdf::ScaleFactoryConfig mSfConfig;
+
+#ifdef WITH_TESSERACT
+	TesseractPluginConfig mTessConfig;
+#endif
+
+	// stages
+	void binarize(PipelinePage& pp) const;
+	void deskew(PipelinePage& pp) const;
+	void layout(PipelinePage& pp) const;
+	void ocr(PipelinePage& pp) const;
+};
+
+};
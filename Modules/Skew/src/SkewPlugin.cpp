@@ -42,25 +42,57 @@ related links:
 #include "Algorithms.h"
 #include "ImageProcessor.h"
 #include "GraphCut.h"
+#include "PageParser.h"
 
 // skew textline
 #include "SuperPixel.h"
 #include "Utils.h"
 
+// ReadModules
+#include "ImageBridge.h"
+#include "Telemetry.h"
+#include "PyramidSkewEstimation.h"
+#include "PageXmlCache.h"
+#include "Rotation.h"
+#include "SkewPreprocessing.h"
+
 #pragma warning(push, 0)	// no warnings from includes - begin
 #include <QAction>
+#include <QFileInfo>
+#include <QRegularExpression>
 #include <QSettings>
 #include <QVector>
-#include <QVector2D>
-#include <QVector3D>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include <QTextStream>
+
+#include <algorithm>
+#include <vector>
 #pragma warning(pop)		// no warnings from includes - end
 
 namespace rdm {
 
 
-bool lessThanSkew(const QVector3D v1, const QVector3D v2) {
+/// <summary>
+/// Mean of the q (e.g. 80 %) smallest errors (partial sort - no full sort needed).
+/// </summary>
+double topError(std::vector<float>& errors, double q) {
+
+	if (errors.empty())
+		return 0.0;
+
+	size_t m = qMin((size_t)(errors.size() * q), errors.size() - 1);
+	std::nth_element(errors.begin(), errors.begin() + m, errors.end());
+
+	double top = 0;
+	for (size_t i = 0; i <= m; i++)
+		top += errors[i];
 
-	return (std::abs(v1.x() - v1.y()) <= std::abs(v2.x() - v2.y()));
+	return top / (double)qMax(m, (size_t)1);
 }
 
 /**
@@ -76,6 +108,9 @@ SkewEstPlugin::SkewEstPlugin(QObject* parent) : QObject(parent) {
 	runIds[id_skew_doc] = "b849c12a5c124520b1c0b0761e86db37";
 	runIds[id_skew_textline] = "bf0d046c895446069fd0433f92ab8a38";
 	runIds[id_skew_textline_draw] = "78de3e5eef6249fbb2921b0a59d6c716";
+	runIds[id_skew_pyramid] = "c3e8a5f1d27b4e6f9a0b5c4d8e1f2a73";
+	runIds[id_skew_estimate] = "9d4b7e2a61c84f3e8b5a0d6c2e9f1b48";
+	runIds[id_skew_compare] = "2f6a9c1e4b7d4e08a3c5f9b1d6e2c7a0";
 	
 	mRunIDs = runIds.toList();
 
@@ -87,6 +122,9 @@ SkewEstPlugin::SkewEstPlugin(QObject* parent) : QObject(parent) {
 	menuNames[id_skew_doc] = tr("Skew Document");
 	menuNames[id_skew_textline] = tr("Skew Textline");
 	menuNames[id_skew_textline_draw] = tr("Draw Skew Textline");
+	menuNames[id_skew_pyramid] = tr("Skew Pyramid");
+	menuNames[id_skew_estimate] = tr("Estimate Skew Angle");
+	menuNames[id_skew_compare] = tr("Compare Skew Estimators");
 	mMenuNames = menuNames.toList();
 
 	// create menu status tips
@@ -97,6 +135,9 @@ SkewEstPlugin::SkewEstPlugin(QObject* parent) : QObject(parent) {
 	statusTips[id_skew_doc] = tr("Calculates the skew for documents");
 	statusTips[id_skew_textline] = tr("Calculates the skew for documents using textlines");
 	statusTips[id_skew_textline_draw] = tr("Shows a debugging graphics for texlineline skew");
+	statusTips[id_skew_pyramid] = tr("Calculates the skew coarse-to-fine on an image pyramid (fast)");
+	statusTips[id_skew_estimate] = tr("Writes the skew angle to the PAGE XML without rotating the image");
+	statusTips[id_skew_compare] = tr("Runs all skew estimators on the same preprocessed page and records each angle");
 	mMenuStatusTips = statusTips.toList();
 
 	// TODO: this must be a setting! - now it's DISEC
@@ -164,26 +205,58 @@ QSharedPointer<nmc::DkImageContainer> SkewEstPlugin::runPlugin(
 	if (!imgC)
 		return imgC;
 
-	if (runID == mRunIDs[id_skew_native]) {
-
-		QSharedPointer<SkewInfo> skewInfo(new SkewInfo(runID, imgC->filePath()));
-		skewNative(imgC, skewInfo);
-		info = skewInfo;
+	// wrong runID? - do nothing
+	if (!mRunIDs.contains(runID)) {
+		qWarning() << "unknown run ID: " << runID;
+		return imgC;
 	}
-	else if (runID == mRunIDs[id_skew_doc]) {
-		QSharedPointer<SkewInfo> skewInfo(new SkewInfo(runID, imgC->filePath()));
-		skewDoc(imgC, skewInfo);
+
+	TelemetryPage tp(imgC->filePath());
+	QElapsedTimer dt;
+	dt.start();
+
+	QSharedPointer<SkewInfo> skewInfo(new SkewInfo(runID, imgC->filePath()));
+	MatView img(imgC->image());
+
+	// the gray image is computed once and shared by all estimators (the pyramid on demand)
+	QSharedPointer<SkewPreprocessing> pre(new SkewPreprocessing(img, mPyramidCoarseSize));
+	pre->compute();
+
+	if (runID == mRunIDs[id_skew_textline] || runID == mRunIDs[id_skew_textline_draw]) {
+		skewTextLine(imgC, pre->gray(), skewInfo, runID, saveInfo);
+		skewInfo->setTime(dt.nsecsElapsed() / 1e6);
 		info = skewInfo;
+		return imgC;
 	}
-	else if (runID == mRunIDs[id_skew_textline] || runID == mRunIDs[id_skew_textline_draw]) {
-		QSharedPointer<SkewInfo> skewInfo(new SkewInfo(runID, imgC->filePath()));
-		skewTextLine(imgC, skewInfo, runID);
+	else if (runID == mRunIDs[id_skew_compare]) {
+		// the image is not changed
+		compareEstimators(pre, skewInfo);
+		skewInfo->setTime(dt.nsecsElapsed() / 1e6);
 		info = skewInfo;
+		return imgC;
 	}
+
+	double skewAngle = 0;
+
+	// id_skew_estimate uses the configured estimator
+	QString estimator = runID == mRunIDs[id_skew_estimate] ? mEstimator : QString();
+
+	if (runID == mRunIDs[id_skew_native] || estimator == "native")
+		skewAngle = skewNative(pre->gray());
+	else if (runID == mRunIDs[id_skew_doc] || estimator == "doc")
+		skewAngle = skewDoc(pre->gray());
+	else if (runID == mRunIDs[id_skew_pyramid] || estimator == "pyramid")
+		skewAngle = skewPyramid(pre);
 	else
-		qWarning() << "unknown run ID: " << runID;
+		qWarning() << "[Skew] unknown estimator" << estimator << "- use native, doc or pyramid";
+
+	parseGT(imgC->fileName(), skewAngle, skewInfo);
+	applySkew(imgC, img, skewAngle, mEstimateOnly || runID == mRunIDs[id_skew_estimate], saveInfo);
+	skewInfo->setTime(dt.nsecsElapsed() / 1e6);
+	info = skewInfo;
+
+	qDebug() << "skew calculated...";
 
-	// wrong runID? - do nothing
 	return imgC;
 }
 
@@ -194,84 +267,116 @@ void SkewEstPlugin::preLoadPlugin() const {
 
 void SkewEstPlugin::postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo>>& batchInfo) const {
 	
+	Telemetry::instance().flush();
+
 	if (batchInfo.empty())
 		return;
 	
 	int runIdx = mRunIDs.indexOf(batchInfo.first()->id());
 
-	QVector<QVector3D> angles;
-	QVector<QString> filenames;
+	// one buffered writer for all pages - .json/.jsonl writes JSON lines, anything else CSV
+	QString fp = evalFilePath();
+	bool json = fp.endsWith(".json", Qt::CaseInsensitive) || fp.endsWith(".jsonl", Qt::CaseInsensitive);
+
+	QFile file(fp);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+		qWarning() << "[Skew] cannot write the evaluation to" << fp << file.errorString();
+
+	QTextStream out(&file);
+	QStringList estimators;
+
+	std::vector<float> errors;
+	errors.reserve(batchInfo.size());
 
 	double errorAcc = 0;
-	double errorCE = 0;
 	double errCeCnt = 0;
+	double timeAcc = 0;
+
+	// compare estimators
+	QMap<QString, double> estErrorAcc;
+	QMap<QString, double> estCeCnt;
 
 	for (auto bi : batchInfo) {
 
-		if (!bi)
+		SkewInfo* tInfo = dynamic_cast<SkewInfo*>(bi.data());
+
+		if (!tInfo)
 			continue;
 
-		qDebug() << bi->filePath() << "computed...";
-		SkewInfo* tInfo = dynamic_cast<SkewInfo*>(bi.data());
+		double sk = tInfo->skew();
+		double skGT = tInfo->skewGt();
+		double error = std::abs(sk - skGT);
 
-		if (tInfo) {
-			qDebug() << "property: " << tInfo->property();
+		errorAcc += error;
+		if (error <= 0.1)
+			errCeCnt++;
 
-			double sk = tInfo->skew();
-			double skGT = tInfo->skewGt();
-			QString fileN = tInfo->property();
+		timeAcc += tInfo->time();
+		errors.push_back((float)error);
 
-			double error = std::abs(sk - skGT);
-			errorAcc += error;
-			if (error <= 0.1) {
-				errorCE += error;
-				errCeCnt++;
-			}
-			
-			angles.push_back(QVector3D((float)sk, (float)skGT, (float)error));
-			filenames.push_back(fileN);
-			//push back
+		QMap<QString, double> es = tInfo->estimatorSkews();
+		for (auto it = es.constBegin(); it != es.constEnd(); it++) {
+			double e = std::abs(it.value() - skGT);
+			estErrorAcc[it.key()] += e;
+			estCeCnt[it.key()] += e <= 0.1 ? 1 : 0;
 		}
-	}
 
-	//write to file
-	QString fp;
-	//QString fp = "D:\\tmp\\evalSkew.txt";
-	//QString fp = "F:\\flo\\evalSkew.txt";
-	fp = mFilePath;
-	
-	QFile file(fp);
-	if (file.open(QIODevice::WriteOnly)) {
-
-		for (int i = 0; i < angles.size(); i++) {
-
-			QString tmpStr = QString::number(angles[i].x());
-			tmpStr += " ";
-			tmpStr += QString::number(angles[i].y());
-			tmpStr += " ";
-			tmpStr += filenames[i];
-			tmpStr += "\n";
-			QTextStream out(&file);
-			out << tmpStr;
+		if (!file.isOpen())
+			continue;
+
+		if (errors.size() == 1) {
+			estimators = es.keys();
+
+			if (!json)
+				out << "file,skew,skew_gt,error,time_ms" << (estimators.empty() ? QString() : "," + estimators.join(",")) << "\n";
+		}
+
+		if (json) {
+			QJsonObject jo;
+			jo["file"] = tInfo->filePath();
+			jo["skew"] = sk;
+			jo["skew_gt"] = skGT;
+			jo["error"] = error;
+			jo["time_ms"] = tInfo->time();
+
+			if (!es.empty()) {
+				QJsonObject je;
+				for (auto it = es.constBegin(); it != es.constEnd(); it++)
+					je[it.key()] = it.value();
+				jo["estimators"] = je;
+			}
+
+			out << QJsonDocument(jo).toJson(QJsonDocument::Compact) << "\n";
+		}
+		else {
+			// quote file paths (they might contain commas)
+			QString fn = tInfo->filePath();
+			out << "\"" << fn.replace("\"", "\"\"") << "\"," << sk << "," << skGT << "," << error << "," << tInfo->time();
+
+			for (const QString& e : estimators)
+				out << "," << es.value(e);
+			out << "\n";
 		}
-		file.close();
 	}
 
+	out.flush();
+	file.close();
+
+	if (errors.empty())
+		return;
+
 	//write metrics as debug output
-	double aed = errorAcc / (double)angles.size();
-	double ce = (double)errCeCnt / (double)angles.size();
-	//double ce2 = errorCE / (double)errCeCnt;
-	qDebug() << "AED: " << aed;
-	qDebug() << "CE: " << ce;
-	//qDebug() << "CE2: " << ce2;
-	qSort(angles.begin(), angles.end(), lessThanSkew);
-	int m = (int)(angles.size() * 0.8);
-	double top80 = 0;
-	for (int i = 0; i <= m; i++) {
-		top80 += angles[i].z();
+	double n = (double)errors.size();
+	qDebug() << "AED: " << errorAcc / n;
+	qDebug() << "CE: " << errCeCnt / n;
+	qDebug() << "Top80: " << topError(errors, 0.8);
+	qDebug() << "time per page: " << timeAcc / n << "ms";
+
+	for (const QString& e : estErrorAcc.keys()) {
+		qDebug() << e << "AED:" << estErrorAcc[e] / n << "CE:" << estCeCnt[e] / n;
 	}
-	top80 /= (float)m;
-	qDebug() << "Top80: " << top80;
+
+	qInfo() << "[Skew] evaluation of" << errors.size() << "pages written to" << fp;
 
 	rdf::DefaultSettings s;
 	saveSettings(s);
@@ -298,40 +403,135 @@ void SkewEstPlugin::init() {
 	loadSettings(s);
 
 	if (mFilePath.isEmpty()) {
-		mFilePath = "D:\\tmp\\evalSkew.txt";
+		mFilePath = defaultEvalFilePath();
 	}
 }
 
+QString SkewEstPlugin::defaultEvalFilePath() {
+	return QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("evalSkew.csv");
+}
+
+/// <summary>
+/// The evaluation file - falls back to the default if the configured
+/// directory does not exist (e.g. a Windows path on Linux).
+/// </summary>
+QString SkewEstPlugin::evalFilePath() const {
+
+	QFileInfo fi(mFilePath);
+
+	if (mFilePath.isEmpty() || !fi.absoluteDir().exists()) {
+		qWarning() << "[Skew] cannot write to" << mFilePath << "- using" << defaultEvalFilePath();
+		return defaultEvalFilePath();
+	}
+
+	return mFilePath;
+}
+
 void SkewEstPlugin::loadSettings(QSettings & settings)
 {
 	settings.beginGroup("SkewEstimation");
 
 	mFilePath = settings.value("skewEvalPath", mFilePath).toString();
+	mPyramidCoarseSize = settings.value("pyramidCoarseSize", mPyramidCoarseSize).toInt();
+	mPyramidPrecision = settings.value("pyramidPrecision", mPyramidPrecision).toDouble();
+	mEstimateOnly = settings.value("estimateOnly", mEstimateOnly).toBool();
+	mEstimator = settings.value("estimator", mEstimator).toString();
 	settings.endGroup();
 }
 
 void SkewEstPlugin::saveSettings(QSettings & settings) const {
 	settings.beginGroup("SkewEstimation");
 	settings.setValue("skewEvalPath", mFilePath);
+	settings.setValue("pyramidCoarseSize", mPyramidCoarseSize);
+	settings.setValue("pyramidPrecision", mPyramidPrecision);
+	settings.setValue("estimateOnly", mEstimateOnly);
+	settings.setValue("estimator", mEstimator);
 	settings.endGroup();
 }
 
-void SkewEstPlugin::skewTextLine(QSharedPointer<nmc::DkImageContainer>& imgC, QSharedPointer<SkewInfo>& skewInfo, const QString& runId) const {
+double SkewEstPlugin::skewPyramid(const QSharedPointer<SkewPreprocessing>& pre) const {
+
+	// full range on the coarsest level - no window parameters to scale
+	PyramidSkewEstimation pse;
+	pse.setPreprocessing(pre);
+	pse.setRange(mMinAngle, mMaxAngle);
+	pse.setPrecision(mPyramidPrecision * DK_DEG2RAD);
+
+	if (!pse.compute()) {
+		qDebug() << "could not compute skew";
+	}
+
+	return pse.angle();
+}
+
+/// <summary>
+/// Rotates the image by skewAngle (rad).
+/// If estimateOnly is set, the angle is written to the PAGE XML instead
+/// which saves the warp, the color conversion and the re-encoding.
+/// </summary>
+void SkewEstPlugin::applySkew(QSharedPointer<nmc::DkImageContainer>& imgC, const cv::Mat& img, double skewAngle, bool estimateOnly, const nmc::DkSaveInfo& saveInfo) const {
+
+	if (estimateOnly) {
+		writeSkew(imgC->filePath(), QSize(img.cols, img.rows), -skewAngle / CV_PI * 180.0, saveInfo);
+		return;
+	}
+
+	ScopedSpan span("skew/rotate");
+
+	// rotates into a new QImage of the same format (no cvtColor)
+	imgC->setImage(Rotation(skewAngle).rotate(imgC->image()), "Skew corrected");
+}
+
+/// <summary>
+/// Writes the skew (deg, same as SkewInfo::skew) as PAGE custom attribute,
+/// e.g. "skew {angle:-1.250;}". rdf does not read or write the PAGE orientation,
+/// so the tag is added to the page (root region) only - an existing skew tag is replaced.
+/// </summary>
+void SkewEstPlugin::writeSkew(const QString& imgPath, const QSize& imgSize, double skew, const nmc::DkSaveInfo& saveInfo) const {
+
+	QString inputPath = saveInfo.inputFilePath().isEmpty() ? imgPath : saveInfo.inputFilePath();
+	QString outputPath = saveInfo.outputFilePath().isEmpty() ? imgPath : saveInfo.outputFilePath();
+
+	auto xmlPage = PageXmlCache::instance().read(rdf::PageXmlParser::imagePathToXmlPath(inputPath));
+
+	xmlPage->setCreator(QString("CVL"));
+	xmlPage->setImageSize(imgSize);
+	xmlPage->setImageFileName(QFileInfo(imgPath).fileName());
+
+	static const QRegularExpression re("\\s*skew\\s*\\{[^}]*\\}");
+	QString tag = QStringLiteral("skew {angle:") + QString::number(skew, 'f', 3) + QStringLiteral(";}");
+
+	QSharedPointer<rdf::Region> root = xmlPage->rootRegion();
+	QString custom = root->custom().remove(re).trimmed();
+	root->setCustom(custom.isEmpty() ? tag : custom + " " + tag);
+
+	PageXmlCache::instance().write(rdf::PageXmlParser::imagePathToXmlPath(outputPath), xmlPage);
+}
+
+void SkewEstPlugin::skewTextLine(QSharedPointer<nmc::DkImageContainer>& imgC, const cv::Mat& gray, QSharedPointer<SkewInfo>& skewInfo, const QString& runId, const nmc::DkSaveInfo& saveInfo) const {
 
 	if (!imgC)
 		return;
 
-	cv::Mat img = rdf::Image::qImage2Mat(imgC->image());
+	ScopedSpan span("skew/textLine");
+	MatView img(imgC->image());
 
-	rdf::TextLineSkew tls(img);
+	rdf::TextLineSkew tls(gray);
 
 	if (!tls.compute()) {
 		qWarning() << "could not compute text-line based skew estimation";
 	}
 	
+	parseGT(imgC->fileName(), tls.getAngle(), skewInfo);
+
 	cv::Mat oImg;
 	if (runId == mRunIDs[id_skew_textline]) {
 		
+		if (mEstimateOnly) {
+			writeSkew(imgC->filePath(), QSize(img.mat().cols, img.mat().rows), skewInfo->skew(), saveInfo);
+			return;
+		}
+
 		// apply angle to image
 		oImg = tls.rotated(img);
 	}
@@ -339,9 +539,42 @@ void SkewEstPlugin::skewTextLine(QSharedPointer<nmc::DkImageContainer>& imgC, QS
 		oImg = tls.draw(img);
 	}
 
-	imgC->setImage(rdf::Image::mat2QImage(oImg), "Skew corrected");
+	imgC->setImage(ImageBridge::toQImage(oImg), "Skew corrected");
+}
 
-	parseGT(imgC->fileName(), tls.getAngle(), skewInfo);
+/// <summary>
+/// Runs all estimators on the shared preprocessing and records their
+/// angles (deg) in skewInfo. The pyramid's angle is the page's skew.
+/// </summary>
+/// <returns>the pyramid's angle (rad)</returns>
+double SkewEstPlugin::compareEstimators(const QSharedPointer<SkewPreprocessing>& pre, QSharedPointer<SkewInfo>& skewInfo) const {
+
+	ScopedSpan span("skew/compare");
+
+	cv::Mat gray = pre->gray();
+
+	// angles as passed to parseGT
+	QMap<QString, double> angles;
+	angles["native"] = skewNative(gray);
+	angles["doc"] = skewDoc(gray);
+	angles["pyramid"] = skewPyramid(pre);
+
+	{
+		ScopedSpan tSpan("skew/textLine");
+
+		rdf::TextLineSkew tls(gray);
+		if (!tls.compute())
+			qWarning() << "could not compute text-line based skew estimation";
+
+		angles["textline"] = tls.getAngle();
+	}
+
+	for (auto it = angles.constBegin(); it != angles.constEnd(); it++)
+		skewInfo->setEstimatorSkew(it.key(), -it.value() / CV_PI * 180.0);
+
+	parseGT(QFileInfo(skewInfo->filePath()).fileName(), angles["pyramid"], skewInfo);
+
+	return angles["pyramid"];
 }
 
 void SkewEstPlugin::parseGT(const QString & fileName, double skewAngle, QSharedPointer<SkewInfo>& skewInfo) const
@@ -369,13 +602,11 @@ void SkewEstPlugin::parseGT(const QString & fileName, double skewAngle, QSharedP
 
 }
 
-void SkewEstPlugin::skewNative(QSharedPointer<nmc::DkImageContainer>& imgC, QSharedPointer<SkewInfo>& skewInfo) const
+double SkewEstPlugin::skewNative(const cv::Mat& inputImg) const
 {
-
-	QImage img = imgC->image();
+	ScopedSpan span("skew/native");
 
 	rdf::BaseSkewEstimation bse;
-	cv::Mat inputImg = rdf::Image::qImage2Mat(img);
 	//if (inputImg.channels() != 1) cv::cvtColor(inputImg, inputImg, CV_RGB2GRAY);
 
 	bse.setImages(inputImg);
@@ -406,32 +637,16 @@ void SkewEstPlugin::skewNative(QSharedPointer<nmc::DkImageContainer>& imgC, QSha
 		qDebug() << "could not compute skew";
 	}
 
-	double skewAngle = bse.getAngle();
-	skewAngle = -skewAngle / 180.0 * CV_PI;
-
-	cv::Mat rotatedImage = rdf::IP::rotateImage(inputImg, skewAngle);
-	if (rotatedImage.channels() == 1) {
-		cv::cvtColor(rotatedImage, rotatedImage, CV_GRAY2BGRA);
-	}
-
-	QImage result = rdf::Image::mat2QImage(rotatedImage);
-
-	imgC->setImage(result, "Skew corrected");
-
-	//parse string
-	parseGT(imgC->fileName(), skewAngle, skewInfo);
-	qDebug() << "skew calculated...";
-
 	//saveSettings(rdf::Config::instance().settings());
 
+	return -bse.getAngle() / 180.0 * CV_PI;
 }
 
-void SkewEstPlugin::skewDoc(QSharedPointer<nmc::DkImageContainer>& imgC, QSharedPointer<SkewInfo>& skewInfo) const
+double SkewEstPlugin::skewDoc(const cv::Mat& inputImg) const
 {
-	QImage img = imgC->image();
+	ScopedSpan span("skew/doc");
 
 	rdf::BaseSkewEstimation bse;
-	cv::Mat inputImg = rdf::Image::qImage2Mat(img);
 	//if (inputImg.channels() != 1) cv::cvtColor(inputImg, inputImg, CV_RGB2GRAY);
 
 	bse.setImages(inputImg);
@@ -455,24 +670,9 @@ void SkewEstPlugin::skewDoc(QSharedPointer<nmc::DkImageContainer>& imgC, QShared
 		qDebug() << "could not compute skew";
 	}
 
-	double skewAngle = bse.getAngle();
-	skewAngle = -skewAngle / 180.0 * CV_PI;
-
-	cv::Mat rotatedImage = rdf::IP::rotateImage(inputImg, skewAngle);
-	if (rotatedImage.channels() == 1) {
-		cv::cvtColor(rotatedImage, rotatedImage, CV_GRAY2BGRA);
-	}
-
-	QImage result = rdf::Image::mat2QImage(rotatedImage);
-
-	imgC->setImage(result, "Skew corrected");
-
-	parseGT(imgC->fileName(), skewAngle, skewInfo);
-	qDebug() << "skew calculated...";
-
 	//saveSettings(rdf::Config::instance().settings());
 
-
+	return -bse.getAngle() / 180.0 * CV_PI;
 }
 
 // DkTestInfo --------------------------------------------------------------------
@@ -507,5 +707,21 @@ double SkewInfo::skewGt() const
 	return mSkewGt;
 }
 
+void SkewInfo::setTime(double ms) {
+	mTime = ms;
+}
+
+double SkewInfo::time() const {
+	return mTime;
+}
+
+void SkewInfo::setEstimatorSkew(const QString& estimator, double skew) {
+	mEstimatorSkews.insert(estimator, skew);
+}
+
+QMap<QString, double> SkewInfo::estimatorSkews() const {
+	return mEstimatorSkews;
+}
+
 };
 
@@ -41,6 +41,10 @@ related links:
 class QSettings;
 
 
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QMap>
+#pragma warning(pop)		// no warnings from includes - end
+
 // opencv defines
 namespace cv {
 	class Mat;
@@ -48,6 +52,8 @@ namespace cv {
 
 namespace rdm {
 
+class SkewPreprocessing;
+
 
 class SkewInfo : public nmc::DkBatchInfo {
 
@@ -63,10 +69,18 @@ public:
 	void setSkewGt(const double skew);
 	double skewGt() const;
 
+	void setEstimatorSkew(const QString& estimator, double skew);
+	QMap<QString, double> estimatorSkews() const;
+
+	void setTime(double ms);
+	double time() const;
+
 private:
 	QString mProp;
 	double mSkew;
 	double mSkewGt;
+	QMap<QString, double> mEstimatorSkews;	// deg (compare estimators)
+	double mTime = 0;						// ms per page
 
 };
 
@@ -101,6 +115,9 @@ public:
 		id_skew_doc,
 		id_skew_textline,
 		id_skew_textline_draw,
+		id_skew_pyramid,
+		id_skew_estimate,
+		id_skew_compare,
 		// add actions here
 
 		id_end
@@ -118,14 +135,25 @@ protected:
 	double mMinAngle = -CV_PI/2.0;
 	double mMaxAngle = CV_PI/2.0;
 
+	int mPyramidCoarseSize = 512;		// px - max side of the coarsest pyramid level
+	double mPyramidPrecision = 0.05;	// deg - finer levels are skipped
+	bool mEstimateOnly = false;			// write angles (PAGE & SkewInfo) without rotating the image
+	QString mEstimator = "doc";			// estimator of id_skew_estimate: native, doc or pyramid
+
 private:
 	void init();
+	QString evalFilePath() const;
+	static QString defaultEvalFilePath();
 	void loadSettings(QSettings& settings);
 	void saveSettings(QSettings& settings) const;
 
-	void skewNative(QSharedPointer<nmc::DkImageContainer>& imgC, QSharedPointer<SkewInfo>& skewInfo) const;
-	void skewDoc(QSharedPointer<nmc::DkImageContainer>& imgC, QSharedPointer<SkewInfo>& skewInfo) const;
-	void skewTextLine(QSharedPointer<nmc::DkImageContainer>& imgC, QSharedPointer<SkewInfo>& skewInfo, const QString& runId) const;
+	double skewNative(const cv::Mat& img) const;
+	double skewDoc(const cv::Mat& img) const;
+	double skewPyramid(const QSharedPointer<SkewPreprocessing>& pre) const;
+	void skewTextLine(QSharedPointer<nmc::DkImageContainer>& imgC, const cv::Mat& gray, QSharedPointer<SkewInfo>& skewInfo, const QString& runId, const nmc::DkSaveInfo& saveInfo) const;
+	double compareEstimators(const QSharedPointer<SkewPreprocessing>& pre, QSharedPointer<SkewInfo>& skewInfo) const;
+	void applySkew(QSharedPointer<nmc::DkImageContainer>& imgC, const cv::Mat& img, double skewAngle, bool estimateOnly, const nmc::DkSaveInfo& saveInfo) const;
+	void writeSkew(const QString& imgPath, const QSize& imgSize, double skew, const nmc::DkSaveInfo& saveInfo) const;
 	void parseGT(const QString& fileName, double skewAngle, QSharedPointer<SkewInfo>& skewInfo) const;
 };
 };
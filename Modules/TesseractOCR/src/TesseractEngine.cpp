@@ -0,0 +1,1126 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#include "TesseractEngine.h"
+
+// ReadFramework
+#include "Settings.h"
+#include "PageParser.h"
+#include "Drawer.h"
+
+// ReadModules
+#include "Telemetry.h"
+
+//tesseract
+#include <allheaders.h> // leptonica main header for image io
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QRegularExpression>
+#include <QPainter>
+#include <QSettings>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrentMap>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#pragma warning(pop)		// no warnings from includes - end
+
+namespace rdm {
+
+// TesseractPageConverter--------------------------------------------------------------------------
+
+TesseractPageConverter::TesseractPageConverter(int textLevel, bool singleLevelOutput) {
+	mTextLevel = textLevel;
+	mSingleLevelOutput = singleLevelOutput;
+}
+
+void TesseractPageConverter::setConfidences(bool confidences) {
+	mConfidences = confidences;
+}
+
+void TesseractPageConverter::convert(tesseract::ResultIterator* pageResults, const QSharedPointer<rdf::PageElement> xmlPage) const {
+
+	if (!pageResults)
+		return;
+
+	int ol = mTextLevel;
+
+	if (ol < 0 || ol>3) {
+		ol = 1;
+		qWarning() << "Tesseract plugin: TextLevel has to be an Integer from 0-3: 0(block), 1(paragraph), 2(line), 3(word))";
+		qInfo() << "Tesseract plugin: TextLevel set to 1.";
+	}
+
+	tesseract::PageIteratorLevel outputLevel = static_cast<tesseract::PageIteratorLevel>(ol);
+
+	convertRegions(outputLevel, pageResults, xmlPage->rootRegion());
+
+	if (mSingleLevelOutput) {
+		QVector<QSharedPointer<rdf::Region>> regions;
+
+		if (ol == 2) {
+			regions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_line);
+		}
+		else if (ol == 3) {
+			regions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_word);
+		}
+		else {
+			regions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_region);
+		}
+
+		if (!regions.isEmpty()){
+			xmlPage->rootRegion()->removeAllChildren();
+			for (QSharedPointer<rdf::Region> c : regions) {
+				if (c->children().isEmpty()) {	// do not add RIL_BLOCK elements
+					xmlPage->rootRegion()->addChild(c);
+				}
+			}
+		}
+	}
+}
+
+// walks the iterator once at the output level - a region is opened whenever the iterator
+// is at the beginning of a coarser level. stack[l] is the parent of level l elements.
+void TesseractPageConverter::convertRegions(const tesseract::PageIteratorLevel fil, tesseract::ResultIterator* ri, QSharedPointer<rdf::Region> root) const {
+
+	QVector<QSharedPointer<rdf::Region>> stack(fil + 2);
+	stack[tesseract::RIL_BLOCK] = root;
+
+	while (!ri->Empty(tesseract::RIL_BLOCK)) {
+
+		// skip images, separators, etc.
+		if (!PTIsTextType(ri->BlockType()) || ri->Empty(fil)) {
+			if (!ri->Next(tesseract::RIL_BLOCK))
+				break;
+			continue;
+		}
+
+		for (int l = tesseract::RIL_BLOCK; l <= fil; l++) {
+
+			if (!stack[l + 1].isNull() && !ri->IsAtBeginningOf(static_cast<tesseract::PageIteratorLevel>(l)))
+				continue;
+
+			QSharedPointer<rdf::Region> child;
+			tesseract::PageIteratorLevel cil = static_cast<tesseract::PageIteratorLevel>(l);
+
+			if (cil == tesseract::RIL_TEXTLINE) {
+				child = createTextLine(ri, fil);
+			}
+			else {
+				child = createTextRegion(ri, cil, fil);
+			}
+
+			stack[l]->addChild(child);
+			stack[l + 1] = child;
+		}
+
+		if (!ri->Next(fil))
+			break;
+	}
+}
+
+QSharedPointer<rdf::TextRegion> TesseractPageConverter::createTextRegion(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel riLevel, 
+	const tesseract::PageIteratorLevel outputLevel, bool textAtAllLevels) const {
+
+	// TODO find a more general way to create all kinds of text region in one function
+
+	//create text region element
+	QSharedPointer<rdf::TextRegion> textRegion(new rdf::TextRegion());
+
+	int x1, y1, x2, y2;
+	ri->BoundingBox(riLevel, &x1, &y1, &x2, &y2);
+	rdf::Rect r(QRect(QPoint(x1, y1), QPoint(x2, y2)));
+	textRegion->setPolygon(rdf::Polygon::fromRect(r));
+	
+	if (riLevel == outputLevel || textAtAllLevels) {
+		char* text = ri->GetUTF8Text(riLevel);
+		//qDebug("new block found: %s", text);
+		textRegion->setText(QString::fromUtf8(text));
+		delete[] text;
+	}
+
+	textRegion->setId(stripBraces(textRegion->id()));	// remove parentheses to please Aletheia and avoid errors
+
+	if (riLevel == tesseract::PageIteratorLevel::RIL_WORD) {
+		textRegion->setType(rdf::Region::type_word);
+	}
+
+	if (mConfidences)
+		textRegion->setCustom(confidenceTag(ri, riLevel));
+
+	// NOTE word font attributes (ri->WordFontAttributes) are currently not available for tess 4.0 LSTM mode
+
+	return textRegion;
+}
+
+QSharedPointer<rdf::TextLine> TesseractPageConverter::createTextLine(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel outputLevel, bool textAtAllLevels) const {
+
+	//create text region element
+	QSharedPointer<rdf::TextLine> textLine(new rdf::TextLine());
+
+	int x1, y1, x2, y2;
+	ri->BoundingBox(tesseract::RIL_TEXTLINE, &x1, &y1, &x2, &y2);
+	rdf::Rect r(QRect(QPoint(x1, y1), QPoint(x2, y2)));
+	textLine->setPolygon(rdf::Polygon::fromRect(r));
+
+	if (outputLevel == tesseract::RIL_TEXTLINE || textAtAllLevels) {
+		char* text = ri->GetUTF8Text(tesseract::RIL_TEXTLINE);
+		//qDebug("new block found: %s", text);
+		textLine->setText(QString::fromUtf8(text));
+		delete[] text;
+	}
+
+	textLine->setId(stripBraces(textLine->id()));	// remove parentheses to please Aletheia and avoid errors
+
+	if (mConfidences)
+		textLine->setCustom(confidenceTag(ri, tesseract::RIL_TEXTLINE));
+
+	return textLine;
+}
+
+// PAGE custom attribute, e.g. "confidence {value:91.3;}"
+QString TesseractPageConverter::confidenceTag(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel level) const {
+	return QStringLiteral("confidence {value:") + QString::number(ri->Confidence(level), 'f', 1) + QStringLiteral(";}");
+}
+
+// QUuid ids are {...} - one copy instead of two remove() calls
+QString TesseractPageConverter::stripBraces(const QString& id) {
+
+	if (id.size() >= 2 && id.startsWith(QLatin1Char('{')) && id.endsWith(QLatin1Char('}')))
+		return id.mid(1, id.size() - 2);
+
+	return id;
+}
+
+// extract text region containing no text results
+QVector<QSharedPointer<rdf::Region>> TesseractEngine::extractTextRegions(const QSharedPointer<rdf::PageElement> xmlPage) {
+
+	// get text regions from existing xml (type_text_region + type_text_line)
+	QVector<QSharedPointer<rdf::Region>> tRegions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_region);
+	tRegions = tRegions + rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_line);
+	
+	QVector<QSharedPointer<rdf::Region>> emptyTextRegions;
+
+	for (auto r : tRegions) {
+
+		if (!r->isEmpty() && !r->polygon().isEmpty()) {
+
+			if (r->type() == rdf::Region::type_text_region) {
+				auto trc = qSharedPointerCast<rdf::TextRegion>(r);
+				if (trc->text().isEmpty()) {
+					emptyTextRegions.append(r);
+				}
+			}
+			else if (r->type() == rdf::Region::type_text_line) {
+				auto trc = qSharedPointerCast<rdf::TextLine>(r);
+				if (trc->text().isEmpty()) {
+					emptyTextRegions.append(r);
+				}
+			}
+		}
+	}
+
+	qWarning() << "Tesseract plugin: Found" << emptyTextRegions.size() << "empty text regions where text recognition results will be added.";
+
+	return emptyTextRegions;
+}
+
+// TesseractEngine functions--------------------------------------------------------------------------
+
+// converts the image once per page so that tesseract's own thresholding and copies work on less data
+QImage TesseractEngine::normalizeImage(const QImage& img, int format) {
+
+	if (img.isNull() || format == input_native)
+		return img;
+
+	if (img.format() == QImage::Format_Mono || img.format() == QImage::Format_MonoLSB)
+		return img.convertToFormat(QImage::Format_Mono);
+
+	QImage gImg = img.format() == QImage::Format_Grayscale8 ? img : img.convertToFormat(QImage::Format_Grayscale8);
+
+	if (format != input_binary)
+		return gImg;
+
+	// binary images (e.g. an inverted BinarizationSuAdapted result) pass Otsu unchanged
+	QImage bwImg(gImg.size(), QImage::Format_Grayscale8);
+	cv::Mat src(gImg.height(), gImg.width(), CV_8UC1, const_cast<uchar*>(gImg.constBits()), gImg.bytesPerLine());
+	cv::Mat dst(bwImg.height(), bwImg.width(), CV_8UC1, bwImg.bits(), bwImg.bytesPerLine());
+	cv::threshold(src, dst, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+
+	return bwImg.convertToFormat(QImage::Format_Mono, Qt::ThresholdDither);
+}
+
+TesseractEngine::TesseractEngine() {	
+	mTessAPI = new tesseract::TessBaseAPI();
+}
+
+TesseractEngine::~TesseractEngine() {
+	mTessAPI->End();
+	delete mTessAPI;
+	qDebug() << "Tesseract plugin: destroying tesseract engine...";
+}
+
+bool TesseractEngine::init(const QString tessdataDir, const QString language, tesseract::OcrEngineMode oem) {
+
+	QByteArray lang = language.toUtf8();
+	
+	qInfo() << "Using tesseract version " << mTessAPI->Version();
+	if (mTessAPI->Init(tessdataDir.toStdString().c_str(), lang.constData(), oem)==-1){
+		qWarning() << "Tesseract plugin: Could not initialize tesseract API!";
+		qWarning() << "Tesseract plugin: Set path to tessdata folder using config plugin!";
+		qWarning() << "Tesseract plugin: If tessdata folder is missing, create it and download eng.traineddata from github https:\\\\github.com\\tesseract-ocr\\tessdata";
+		return false;
+	}
+	else {
+		qInfo() << "Tesseract plugin: Initialized tesseract API.";
+		qInfo() << "Tesseract plugin: Using tesseract version: " << mTessAPI->Version();
+		
+		tesseract::OcrEngineMode cOEM =  mTessAPI->oem();
+		qInfo() << "Tesseract plugin: Using OCR engine mode: " << cOEM;
+	}
+
+	mKey = key(tessdataDir, language, oem);
+	mTessdataDir = tessdataDir;
+	mLanguage = language;
+	mOem = oem;
+
+	return true;
+}
+
+// releases the image and the recognition results - but keeps the models loaded
+void TesseractEngine::clear() {
+	mTessAPI->Clear();
+	mImageKey = 0;
+	mCache.clear();
+}
+
+void TesseractEngine::setCache(QSharedPointer<TesseractResultCache> cache) {
+	mCache = cache;
+}
+
+QString TesseractEngine::key() const {
+	return mKey;
+}
+
+QString TesseractEngine::key(const QString& tessdataDir, const QString& language, tesseract::OcrEngineMode oem) {
+	return tessdataDir + "|" + language + "|" + QString::number(oem);
+}
+
+// TesseractResultCache--------------------------------------------------------------------------
+namespace {
+	const QByteArray cacheMagic("RDMOCR01");
+	const int cacheKeySize = 20;	// sha1
+}
+
+TesseractResultCache::TesseractResultCache(const QString& filePath) : mFilePath(filePath), mFile(filePath) {
+	load();
+}
+
+QSharedPointer<TesseractResultCache> TesseractResultCache::forCollection(const QString& dirPath) {
+
+	static QMutex mutex;
+	static QHash<QString, QSharedPointer<TesseractResultCache> > caches;
+
+	QString fp = QDir(dirPath).absoluteFilePath("tesseract-cache.bin");
+
+	QMutexLocker lock(&mutex);
+	auto it = caches.find(fp);
+	if (it != caches.end())
+		return it.value();
+
+	QSharedPointer<TesseractResultCache> cache(new TesseractResultCache(fp));
+	caches.insert(fp, cache);
+
+	return cache;
+}
+
+QByteArray TesseractResultCache::key(const QImage& img, const QRect& rect, const QString& engineKey) {
+
+	QRect r = rect.intersected(img.rect());
+
+	QCryptographicHash hash(QCryptographicHash::Sha1);
+	hash.addData(engineKey.toUtf8());
+
+	int header[3] = { img.format(), r.width(), r.height() };
+	hash.addData(reinterpret_cast<const char*>(header), sizeof(header));
+
+	// only the pixels of the region rect are hashed (byte aligned for 1 bpp images)
+	int x0 = r.left() * img.depth() / 8;
+	int x1 = ((r.right() + 1) * img.depth() + 7) / 8;
+
+	for (int y = r.top(); y <= r.bottom(); y++)
+		hash.addData(reinterpret_cast<const char*>(img.constScanLine(y)) + x0, x1 - x0);
+
+	return hash.result();
+}
+
+bool TesseractResultCache::find(const QByteArray& key, Entry& entry) const {
+
+	QMutexLocker lock(&mMutex);
+	auto it = mEntries.constFind(key);
+
+	if (it == mEntries.constEnd())
+		return false;
+
+	entry = it.value();
+	return true;
+}
+
+void TesseractResultCache::insert(const QByteArray& key, const Entry& entry) {
+
+	if (key.size() != cacheKeySize)
+		return;
+
+	QByteArray text = entry.text.toUtf8();
+
+	// record: key | confidence | size | utf8 text
+	QByteArray record = key;
+	qint32 meta[2] = { entry.confidence, text.size() };
+	record.append(reinterpret_cast<const char*>(meta), sizeof(meta));
+	record.append(text);
+
+	QMutexLocker lock(&mMutex);
+	mEntries.insert(key, entry);
+
+	if (!mFile.isOpen()) {
+
+		QDir().mkpath(QFileInfo(mFilePath).absolutePath());
+
+		if (!mFile.open(QIODevice::ReadWrite)) {
+			qWarning() << "[Tesseract] cannot write OCR cache:" << mFilePath;
+			return;
+		}
+	}
+
+	// other processes (e.g. several read-batch instances) might append to the same file
+	QLockFile lf(mFilePath + ".lock");
+	if (!lf.tryLock(5000)) {
+		qWarning() << "[Tesseract] cannot lock OCR cache:" << mFilePath;
+		return;
+	}
+
+	if (mFile.size() == 0)
+		mFile.write(cacheMagic);
+
+	mFile.seek(mFile.size());
+	mFile.write(record);
+	mFile.flush();
+}
+
+QString TesseractResultCache::filePath() const {
+	return mFilePath;
+}
+
+int TesseractResultCache::size() const {
+
+	QMutexLocker lock(&mMutex);
+	return mEntries.size();
+}
+
+void TesseractResultCache::load() {
+
+	QFile file(mFilePath);
+	if (!file.open(QIODevice::ReadOnly))
+		return;
+
+	// same lock as insert() - another process might be appending or have just created the file
+	QLockFile lf(mFilePath + ".lock");
+	if (!lf.tryLock(5000)) {
+		qWarning() << "[Tesseract] cannot lock OCR cache (not loaded):" << mFilePath;
+		return;
+	}
+
+	qint64 fileSize = file.size();
+
+	// created but the magic is not written yet - insert() writes it
+	if (fileSize == 0)
+		return;
+
+	const uchar* data = file.map(0, fileSize);
+
+	if (!data || fileSize < cacheMagic.size() || memcmp(data, cacheMagic.constData(), cacheMagic.size()) != 0) {
+		qWarning() << "[Tesseract] removing invalid OCR cache:" << mFilePath;
+		file.close();
+		QFile::remove(mFilePath);
+		return;
+	}
+
+	qint64 pos = cacheMagic.size();
+	const qint64 headerSize = cacheKeySize + 2 * sizeof(qint32);
+
+	while (pos + headerSize <= fileSize) {
+
+		qint32 meta[2];
+		memcpy(meta, data + pos + cacheKeySize, sizeof(meta));
+
+		// truncated record (e.g. the process was killed)
+		if (meta[1] < 0 || pos + headerSize + meta[1] > fileSize)
+			break;
+
+		Entry e;
+		e.confidence = meta[0];
+		e.text = QString::fromUtf8(reinterpret_cast<const char*>(data + pos + headerSize), meta[1]);
+		mEntries.insert(QByteArray(reinterpret_cast<const char*>(data + pos), cacheKeySize), e);
+
+		pos += headerSize + meta[1];
+	}
+
+	file.unmap(const_cast<uchar*>(data));
+	file.close();
+
+	// new records are appended after the last valid one
+	if (pos < fileSize)
+		QFile::resize(mFilePath, pos);
+
+	qInfo() << "[Tesseract]" << mEntries.size() << "cached OCR results loaded from" << mFilePath;
+}
+
+// TesseractCheckpoint--------------------------------------------------------------------------
+TesseractCheckpoint::TesseractCheckpoint(const QString& xmlPath) {
+
+	if (!xmlPath.isEmpty())
+		mFilePath = xmlPath + ".part";
+}
+
+// returns the page of the last checkpoint or a null pointer if there is none
+// checkpoints older than the input PAGE file (e.g. a corrected layout) are removed
+QSharedPointer<rdf::PageElement> TesseractCheckpoint::resume(const QString& inputXmlPath) const {
+
+	QFileInfo fi(mFilePath);
+
+	if (isEmpty() || !fi.exists())
+		return QSharedPointer<rdf::PageElement>();
+
+	QFileInfo ifi(inputXmlPath);
+	if (!inputXmlPath.isEmpty() && ifi.exists() && ifi.lastModified() > fi.lastModified()) {
+		qInfo() << "Tesseract plugin: removing outdated checkpoint" << mFilePath;
+		finish();
+		return QSharedPointer<rdf::PageElement>();
+	}
+
+	rdf::PageXmlParser parser;
+	if (!parser.read(mFilePath))
+		return QSharedPointer<rdf::PageElement>();
+
+	qInfo() << "Tesseract plugin: resuming from" << mFilePath;
+
+	return parser.page();
+}
+
+void TesseractCheckpoint::write(const QSharedPointer<rdf::PageElement> page) const {
+
+	if (isEmpty() || !page)
+		return;
+
+	// replace the old checkpoint only if the new one was written completely
+	QString tmpPath = mFilePath + ".tmp";
+
+	rdf::PageXmlParser parser;
+	parser.write(tmpPath, page);
+
+	QFile::remove(mFilePath);
+	QFile::rename(tmpPath, mFilePath);
+}
+
+// call after the final PAGE file is written
+void TesseractCheckpoint::finish() const {
+
+	if (!isEmpty())
+		QFile::remove(mFilePath);
+}
+
+bool TesseractCheckpoint::isEmpty() const {
+	return mFilePath.isEmpty();
+}
+
+QString TesseractCheckpoint::filePath() const {
+	return mFilePath;
+}
+
+// TesseractEnginePool--------------------------------------------------------------------------
+TesseractEnginePool::TesseractEnginePool() {
+
+	// batches run one page per core - keep one engine for each of them
+	mMaxIdle = qMax(QThread::idealThreadCount(), 1);
+}
+
+TesseractEnginePool::~TesseractEnginePool() {
+	clear();
+}
+
+TesseractEnginePool& TesseractEnginePool::instance() {
+
+	static TesseractEnginePool pool;
+	return pool;
+}
+
+QSharedPointer<TesseractEngine> TesseractEnginePool::acquire(const TesseractPluginConfig& config) {
+	return acquire(config.TessdataDir(), config.language(), config.engineMode());
+}
+
+QSharedPointer<TesseractEngine> TesseractEnginePool::acquire(const QString& tessdataDir, const QString& language, tesseract::OcrEngineMode oem) {
+
+	QString k = TesseractEngine::key(tessdataDir, language, oem);
+	TesseractEngine* engine = 0;
+
+	{
+		QMutexLocker lock(&mMutex);
+		auto it = mIdle.find(k);
+		if (it != mIdle.end()) {
+			engine = it.value();
+			mIdle.erase(it);
+		}
+	}
+
+	// init outside the lock - loading the models takes a while
+	if (!engine) {
+		engine = new TesseractEngine();
+
+		if (!engine->init(tessdataDir, language, oem)) {
+			delete engine;
+			return QSharedPointer<TesseractEngine>();
+		}
+	}
+
+	return QSharedPointer<TesseractEngine>(engine, [](TesseractEngine* e) {
+		TesseractEnginePool::instance().release(e);
+	});
+}
+
+void TesseractEnginePool::release(TesseractEngine* engine) {
+
+	engine->clear();
+
+	// the cap is per key - engines of all configured languages stay warm
+	QMutexLocker lock(&mMutex);
+	if (mIdle.count(engine->key()) < mMaxIdle) {
+		mIdle.insert(engine->key(), engine);
+		return;
+	}
+
+	lock.unlock();
+	delete engine;
+}
+
+void TesseractEnginePool::clear() {
+
+	QMutexLocker lock(&mMutex);
+	qDeleteAll(mIdle);
+	mIdle.clear();
+}
+
+// the image is only passed (and converted) if it changed - regions of a page
+// are then recognized with SetRectangle() on the same image
+void TesseractEngine::setImage(const QImage img) {	
+
+	if (mImageKey != 0 && img.cacheKey() == mImageKey)
+		return;
+
+	mImageKey = img.cacheKey();
+
+	if (img.format() != QImage::Format_Mono) {
+		// NOTE: bytesPerLine() / width() is wrong for padded scan lines
+		mTessAPI->SetImage(img.bits(), img.width(), img.height(), img.depth() / 8, img.bytesPerLine());
+		return;
+	}
+
+	// 1 bpp: QImage's Format_Mono has the same (MSB first) bit order as leptonica
+	Pix* pix = pixCreate(img.width(), img.height(), 1);
+	l_uint32* pixData = pixGetData(pix);
+	int pixBpl = pixGetWpl(pix) * 4;
+	int rowBytes = (img.width() + 7) / 8;
+
+	for (int y = 0; y < img.height(); y++)
+		memcpy(reinterpret_cast<uchar*>(pixData) + y * pixBpl, img.constScanLine(y), rowBytes);
+
+	pixEndianByteSwap(pix);
+
+	// leptonica: 1 is foreground (black)
+	if (qGray(img.color(1)) > 127)
+		pixInvert(pix, pix);
+
+	mTessAPI->SetImage(pix);
+	pixDestroy(&pix);
+}
+
+void TesseractEngine::setRectangle(const rdf::Rect rect) {
+
+	mTessAPI->SetRectangle((int)rect.topLeft().x(), (int)rect.topLeft().y(), (int)rect.width(), (int)rect.height());
+}
+
+tesseract::ResultIterator* TesseractEngine::processPage(const QImage img) {
+
+	ScopedSpan span("ocr/page");
+	setImage(img);
+
+	//set tess parameters
+	mTessAPI->SetPageSegMode(tesseract::PageSegMode::PSM_AUTO);
+	mTessAPI->SetVariable("save_best_choices", "T");
+	mTessAPI->Recognize(0);
+
+	tesseract::ResultIterator* ri = mTessAPI->GetIterator();
+
+	return ri;
+}
+
+QImage TesseractEngine::processTextRegions(QImage img, QVector<QSharedPointer<rdf::Region>> textRegions, bool parallel){
+
+	recognizeTextRegions(img, textRegions, parallel);
+
+	return drawRegions(img, textRegions);
+}
+
+// routes each region to an engine of its language, the engines stay warm in the pool
+void TesseractEngine::routeTextRegions(const QImage& img, const QSharedPointer<rdf::PageElement> xmlPage, const QVector<QSharedPointer<rdf::Region>>& textRegions, 
+	const TesseractPluginConfig& config, QSharedPointer<TesseractResultCache> cache, const TesseractCheckpoint& checkpoint) {
+
+	QMap<QString, QVector<QSharedPointer<rdf::Region>>> routes;
+
+	if (config.routeLanguages())
+		routes = routeByLanguage(xmlPage, textRegions, config.languages());
+	else
+		routes.insert(config.language(), textRegions);
+
+	for (auto it = routes.begin(); it != routes.end(); it++) {
+
+		QSharedPointer<TesseractEngine> engine = TesseractEnginePool::instance().acquire(config.TessdataDir(), it.key(), config.engineMode());
+
+		if (!engine) {
+			qWarning() << "Tesseract plugin: no engine for" << it.key() << "-" << it.value().size() << "regions are skipped";
+			continue;
+		}
+
+		engine->setCache(cache);
+
+		int interval = checkpoint.isEmpty() || config.checkpointInterval() <= 0 ? it.value().size() : config.checkpointInterval();
+
+		bool lastRoute = (it + 1) == routes.end();
+
+		for (int idx = 0; idx < it.value().size(); idx += interval) {
+
+			engine->recognizeTextRegions(img, it.value().mid(idx, interval), config.parallelRegions());
+
+			// the caller writes the final PAGE file after the last chunk
+			bool lastChunk = lastRoute && idx + interval >= it.value().size();
+
+			if (!checkpoint.isEmpty() && !lastChunk)
+				checkpoint.write(xmlPage);
+		}
+	}
+}
+
+QMap<QString, QVector<QSharedPointer<rdf::Region>>> TesseractEngine::routeByLanguage(const QSharedPointer<rdf::PageElement> xmlPage, 
+	const QVector<QSharedPointer<rdf::Region>>& textRegions, const QStringList& languages) {
+
+	QString defaultLang = languages.isEmpty() ? QString("eng") : languages.first();
+
+	// regions inherit the language of their parents (e.g. lines of a German text region)
+	QHash<const rdf::Region*, QString> regionLangs;
+	QVector<QPair<QSharedPointer<rdf::Region>, QString>> stack;
+	stack << qMakePair(xmlPage->rootRegion(), defaultLang);
+
+	while (!stack.isEmpty()) {
+
+		auto c = stack.takeLast();
+		if (c.first.isNull())
+			continue;
+
+		QString lang = regionLanguage(c.first);
+		if (lang.isEmpty())
+			lang = c.second;
+		else if (!languages.contains(lang)) {
+			qWarning() << "Tesseract plugin:" << lang << "is not in the configured languages - using" << defaultLang;
+			lang = defaultLang;
+		}
+
+		regionLangs.insert(c.first.data(), lang);
+
+		for (auto child : c.first->children())
+			stack << qMakePair(child, lang);
+	}
+
+	QMap<QString, QVector<QSharedPointer<rdf::Region>>> routes;
+	for (auto r : textRegions)
+		routes[regionLangs.value(r.data(), defaultLang)] << r;
+
+	return routes;
+}
+
+// PAGE custom attribute, e.g. "language {value:deu;}"
+QString TesseractEngine::regionLanguage(const QSharedPointer<rdf::Region> region) {
+
+	static const QRegularExpression re("language\\s*\\{[^}]*value:\\s*([^;}\\s]+)");
+
+	QRegularExpressionMatch m = re.match(region->custom());
+
+	return m.hasMatch() ? m.captured(1) : QString();
+}
+
+void TesseractEngine::recognizeTextRegions(const QImage& img, const QVector<QSharedPointer<rdf::Region>>& textRegions, bool parallel) {
+
+	ScopedSpan span("ocr/regions");
+
+	// only use pool threads that are idle - in batches, all of them are busy with other pages
+	QThreadPool* pool = QThreadPool::globalInstance();
+	int numFree = qMax(pool->maxThreadCount() - pool->activeThreadCount(), 0) + 1;	// +1: this thread
+	int numShards = parallel ? qMin(qMin(QThread::idealThreadCount(), numFree), textRegions.size()) : 1;
+
+	if (numShards <= 1) {
+		recognizeRegions(img, textRegions);
+	}
+	else {
+
+		// deal the regions round robin - neighboring lines (e.g. of a table) have similar lengths
+		QVector<QVector<QSharedPointer<rdf::Region>>> shards(numShards);
+		for (int idx = 0; idx < textRegions.size(); idx++)
+			shards[idx % numShards] << textRegions[idx];
+
+		// the first shard runs on this engine, the others get their own from the pool
+		QVector<int> shardIdx;
+		for (int idx = 0; idx < numShards; idx++)
+			shardIdx << idx;
+
+		QVector<bool> failed(numShards, false);
+
+		QtConcurrent::blockingMap(shardIdx, [&](int idx) {
+
+			if (idx == 0) {
+				recognizeRegions(img, shards[idx]);
+				return;
+			}
+
+			QSharedPointer<TesseractEngine> engine = TesseractEnginePool::instance().acquire(mTessdataDir, mLanguage, mOem);
+
+			if (engine) {
+				engine->setCache(mCache);
+				engine->recognizeRegions(img, shards[idx]);
+			}
+			else
+				failed[idx] = true;
+		});
+
+		for (int idx = 0; idx < numShards; idx++) {
+			if (failed[idx])
+				recognizeRegions(img, shards[idx]);
+		}
+	}
+
+}
+
+QImage TesseractEngine::drawRegions(const QImage& img, const QVector<QSharedPointer<rdf::Region>>& textRegions) {
+
+	// TODO fix coloring of drawn items
+	QImage result = img.depth() < 32 ? img.convertToFormat(QImage::Format_RGB32) : img.copy();
+	QPainter myPainter(&result);
+	myPainter.setPen(QPen(QBrush(rdf::ColorManager::blue()), 3));
+	myPainter.setBrush(Qt::NoBrush);
+
+	for (auto r : textRegions) {
+
+		if (r.isNull()) {
+			continue;
+		}
+
+		myPainter.drawPolyline(r->polygon().closedPolygon().begin(), r->polygon().closedPolygon().size());
+	}
+
+	myPainter.end();
+
+	return result;
+}
+
+void TesseractEngine::recognizeRegions(const QImage& img, const QVector<QSharedPointer<rdf::Region>>& textRegions) {
+
+	for (auto r : textRegions) {
+		
+		if (r.isNull()) {
+			continue;
+		}
+
+		// removes isNull() points from polygon - rdf::Rect::fromPoints() method also ignores them
+		//QPolygon poly = r->polygon().polygon().toPolygon();
+		//for (QPoint p : poly) {
+		//	if (p.isNull())
+		//		poly.removeOne(p);
+		//}
+		//r->polygon().setPolygon(QPolygonF(poly));
+		//r->setPolygon(rdf::Polygon(QPolygonF(poly)));
+
+		if (isAARect(r->polygon())) {
+			rdf::Rect rRect = polygonToOCRBox(img.size(), r->polygon());
+			addTextToRegion(img, r, rRect);
+		}
+		else {
+			QImage rImg = getRegionImage(img, r);
+			if (!rImg.isNull())
+				addTextToRegion(rImg, r);
+		}
+	}
+}
+
+void TesseractEngine::addTextToRegion(const QImage img, QSharedPointer<rdf::Region> region, const rdf::Rect regionRect, const tesseract::PageSegMode psm) {
+
+	QByteArray cacheKey;
+
+	if (mCache) {
+		QRect r = regionRect.isNull() ? img.rect() : regionRect.toQRect();
+		cacheKey = TesseractResultCache::key(img, r, mKey + "|" + QString::number(psm));
+
+		TesseractResultCache::Entry e;
+		if (mCache->find(cacheKey, e)) {
+			setRegionText(region, e.text);
+			return;
+		}
+	}
+
+	TesseractResultCache::Entry e = recognize(img, regionRect, psm);
+	setRegionText(region, e.text);
+
+	if (mCache)
+		mCache->insert(cacheKey, e);
+}
+
+TesseractResultCache::Entry TesseractEngine::recognize(const QImage& img, const rdf::Rect& regionRect, const tesseract::PageSegMode psm) {
+
+	// set rect region and do OCR
+	setImage(img);
+
+	// the image might still hold the rectangle of the last region
+	if (!regionRect.isNull())
+		setRectangle(regionRect);
+	else
+		mTessAPI->SetRectangle(0, 0, img.width(), img.height());
+
+	mTessAPI->SetPageSegMode(psm);
+	mTessAPI->SetVariable("save_best_choices", "T");
+
+	mTessAPI->Recognize(0);
+	char* boxText = mTessAPI->GetUTF8Text();
+
+	TesseractResultCache::Entry e;
+	e.text = QString::fromUtf8(boxText);
+	e.confidence = mTessAPI->MeanTextConf();
+
+	delete[] boxText;
+
+	return e;
+}
+
+void TesseractEngine::setRegionText(QSharedPointer<rdf::Region> region, const QString& text) {
+
+	//write text to regions
+	auto r = region;
+	if (r->type() == rdf::Region::type_text_region) {
+		auto rc = qSharedPointerCast<rdf::TextRegion>(r);
+		rc->setText(text);
+	}
+	else if (r->type() == rdf::Region::type_text_line) {
+		auto rc = qSharedPointerCast<rdf::TextLine>(r);
+		rc->setText(text);
+	}
+}
+
+// get a cropped and masked image of the text region
+QImage TesseractEngine::getRegionImage(const QImage img, const QSharedPointer<rdf::Region> region, const QColor fillColor) const {
+
+	// crop first - only the bounding box (plus padding) is copied and converted, never the whole page
+	QRect box = polygonToOCRBox(img.size(), region->polygon()).toQRect();
+
+	if (box.isEmpty())
+		return QImage();
+
+	QImage croppedRI = img.copy(box);
+	if (croppedRI.format() != QImage::Format_Grayscale8)
+		croppedRI = croppedRI.convertToFormat(QImage::Format_Grayscale8);
+
+	// mask the polygon inside the crop
+	std::vector<std::vector<cv::Point> > poly(1);
+	for (const QPointF& p : region->polygon().polygon())
+		poly[0].push_back(cv::Point(qRound(p.x()) - box.left(), qRound(p.y()) - box.top()));
+
+	cv::Mat outside(croppedRI.height(), croppedRI.width(), CV_8UC1, cv::Scalar(255));
+	cv::fillPoly(outside, poly, cv::Scalar(0));
+
+	cv::Mat cropMat(croppedRI.height(), croppedRI.width(), CV_8UC1, croppedRI.bits(), croppedRI.bytesPerLine());
+	cropMat.setTo(cv::Scalar(qGray(fillColor.rgb())), outside);
+
+	return croppedRI;
+}
+
+rdf::Rect TesseractEngine::polygonToOCRBox(const QSize imgSize, const rdf::Polygon poly) const {
+
+	rdf::Rect ocrBox = rdf::Rect::fromPoints(poly.toPoints());		// warning: fromPoints ignores point (0,0)
+	ocrBox.expand(10); // expanding image improves OCR results - avoids errors if text is connected to the image border
+	ocrBox = ocrBox.clipped(rdf::Vector2D(imgSize));
+
+	return ocrBox;
+}
+
+// returns true if polygon is an axis aligned rectangle
+bool TesseractEngine::isAARect(rdf::Polygon poly) {
+
+	// TODO test/debug function
+	
+	if (poly.size() == 4) {
+
+		QVector<rdf::Vector2D> pts;
+
+		for (const QPointF& p : poly.polygon()) {
+			pts << rdf::Vector2D(p);
+		}
+
+		rdf::Vector2D l1 = pts[0] - pts[1];
+		rdf::Vector2D l2 = pts[2] - pts[3];
+		
+		if (l1.length() == l2.length())
+			return true;
+		else
+			return false;
+	}
+	else {
+		return false;
+	}
+}
+
+// tesseract config---------------------------------------------------------------------------
+TesseractPluginConfig::TesseractPluginConfig() : ModuleConfig("TesseractPlugin") {
+}
+
+void TesseractPluginConfig::load(const QSettings & settings) {
+
+	mTessdataDir = settings.value("TessdataDir", mTessdataDir).toString();
+	mLanguage = settings.value("Language", mLanguage).toString();
+	mRouteLanguages = settings.value("RouteLanguages", mRouteLanguages).toBool();
+	mEngineMode = settings.value("EngineMode", mEngineMode).toInt();
+	mTextLevel = settings.value("TextLevel", mTextLevel).toInt();
+	mDrawResults = settings.value("DrawResults", mDrawResults).toBool();
+	mSingleLevelOutput = settings.value("SingleLevelOutput", mSingleLevelOutput).toBool();
+	mParallelRegions = settings.value("ParallelRegions", mParallelRegions).toBool();
+	mInputFormat = settings.value("InputFormat", mInputFormat).toInt();
+	mResultCache = settings.value("ResultCache", mResultCache).toBool();
+	mConfidences = settings.value("Confidences", mConfidences).toBool();
+	mCheckpointInterval = settings.value("CheckpointInterval", mCheckpointInterval).toInt();
+}
+
+void TesseractPluginConfig::save(QSettings & settings) const {
+
+	settings.setValue("TessdataDir", mTessdataDir);
+	settings.setValue("Language", mLanguage);
+	settings.setValue("RouteLanguages", mRouteLanguages);
+	settings.setValue("EngineMode", mEngineMode);
+	settings.setValue("TextLevel", mTextLevel);
+	settings.setValue("DrawResults", mDrawResults);
+	settings.setValue("SingleLevelOutput", mSingleLevelOutput);
+	settings.setValue("ParallelRegions", mParallelRegions);
+	settings.setValue("InputFormat", mInputFormat);
+	settings.setValue("ResultCache", mResultCache);
+	settings.setValue("Confidences", mConfidences);
+	settings.setValue("CheckpointInterval", mCheckpointInterval);
+}
+
+QString TesseractPluginConfig::TessdataDir() const {
+	return mTessdataDir;
+}
+
+QString TesseractPluginConfig::language() const {
+	return mLanguage;
+}
+
+QStringList TesseractPluginConfig::languages() const {
+	return mLanguage.split("+", QString::SkipEmptyParts);
+}
+
+bool TesseractPluginConfig::routeLanguages() const {
+	return mRouteLanguages;
+}
+
+tesseract::OcrEngineMode TesseractPluginConfig::engineMode() const {
+	return static_cast<tesseract::OcrEngineMode>(mEngineMode);
+}
+
+int TesseractPluginConfig::textLevel() const {
+	return mTextLevel;
+}
+
+bool TesseractPluginConfig::drawResults() const {
+	return mDrawResults;
+}
+
+bool TesseractPluginConfig::singleLevelOutput() const {
+	return mSingleLevelOutput;
+}
+
+bool TesseractPluginConfig::parallelRegions() const {
+	return mParallelRegions;
+}
+
+int TesseractPluginConfig::inputFormat() const {
+
+	if (mInputFormat < 0 || mInputFormat >= TesseractEngine::input_end)
+		return TesseractEngine::input_gray;
+
+	return mInputFormat;
+}
+
+bool TesseractPluginConfig::resultCache() const {
+	return mResultCache;
+}
+
+bool TesseractPluginConfig::confidences() const {
+	return mConfidences;
+}
+
+int TesseractPluginConfig::checkpointInterval() const {
+	return mCheckpointInterval;
+}
+
+QString TesseractPluginConfig::toString() const {
+
+	QString msg = rdf::ModuleConfig::toString();
+	msg += "  TessdataDir: " + mTessdataDir;
+	msg += "  Language: " + mLanguage;
+	msg += "  EngineMode: " + QString::number(mEngineMode);
+	msg += "  InputFormat: " + QString::number(mInputFormat);
+	msg += "  TextLevel: " + QString::number(mTextLevel);
+	msg += drawResults() ? " drawing results\n" : " not drawing results\n";
+	msg += singleLevelOutput() ? " single text level exported\n" : " all text levels exported\n";
+	msg += parallelRegions() ? " regions recognized in parallel\n" : " regions recognized sequentially\n";
+	msg += resultCache() ? " OCR results cached\n" : "";
+
+	return msg;
+}
+};
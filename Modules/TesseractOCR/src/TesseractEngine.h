@@ -0,0 +1,283 @@
+/*******************************************************************************************************
+ReadModules are plugins for nomacs developed at CVL/TU Wien for the EU project READ. 
+
+Copyright (C) 2016 Markus Diem <diem@caa.tuwien.ac.at>
+Copyright (C) 2016 Stefan Fiel <fiel@caa.tuwien.ac.at>
+Copyright (C) 2016 Florian Kleber <kleber@caa.tuwien.ac.at>
+
+This file is part of ReadModules.
+
+ReadFramework is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ReadFramework is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+The READ project  has  received  funding  from  the European  Unions  Horizon  2020  
+research  and innovation programme under grant agreement No 674943
+
+related links:
+[1] http://www.caa.tuwien.ac.at/cvl/
+[2] https://transkribus.eu/Transkribus/
+[3] https://github.com/TUWien/
+[4] http://nomacs.org
+*******************************************************************************************************/
+
+#pragma once
+
+// rdf includes
+#include "BaseModule.h"
+#include "Elements.h"
+#include "Shapes.h"
+
+//tesseract includes
+#include <baseapi.h> // tesseract main header
+
+#pragma warning(push, 0)	// no warnings from includes - begin
+#include <QColor>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QMultiHash>
+#include <QMutex>
+#pragma warning(pop)		// no warnings from includes - end
+
+// NOTE: this file is compiled into every module that runs tesseract (TesseractOCR, Pipeline)
+
+namespace rdm {
+
+	class TesseractPluginConfig : public rdf::ModuleConfig {
+
+		public:
+			TesseractPluginConfig();
+
+			virtual QString toString() const override;
+
+			QString TessdataDir() const;
+			//void setTessdataDir(QString dir);
+
+			QString language() const;
+			QStringList languages() const;
+			bool routeLanguages() const;
+			tesseract::OcrEngineMode engineMode() const;
+
+			int textLevel() const;
+			//void setTextLevel(int level);
+
+			bool drawResults() const;
+
+			bool singleLevelOutput() const;
+			//void setDrawResults(bool draw);
+
+			bool parallelRegions() const;
+			int inputFormat() const;
+			bool resultCache() const;
+			bool confidences() const;
+			int checkpointInterval() const;
+
+		private:
+
+			QString mTessdataDir = QString("E:\\dev\\CVL\\ReadModules\\ReadModules\\Modules\\TesseractOCR");
+			QString mLanguage = "eng";		// tesseract language string, e.g. deu+lat+eng
+			bool mRouteLanguages = false;	// one engine per language instead of a combined model
+			int mEngineMode = tesseract::OEM_DEFAULT;
+			int mTextLevel = 2;
+			bool mDrawResults = false;
+			bool mSingleLevelOutput = false;
+			bool mParallelRegions = false;	// batches already run one page per core
+			int mInputFormat = 1;	// TesseractEngine::input_gray
+			bool mResultCache = false;	// writes tesseract-cache.bin next to the PAGE files
+			bool mConfidences = false;
+			int mCheckpointInterval = 0;	// regions between two checkpoints (0 = off)
+
+			void load(const QSettings& settings) override;
+			void save(QSettings& settings) const override;
+	};
+
+	/// <summary>
+	/// Persistent OCR results of a collection.
+	/// Results are keyed by a hash of the (masked) region pixels and the engine config,
+	/// so re-running the OCR after a layout correction only recognizes changed regions.
+	/// All results are stored in a single append-only file which is memory mapped when opened.
+	/// Appends are guarded by a lock file so that several processes can share a collection.
+	/// </summary>
+	class TesseractResultCache {
+
+		public:
+			struct Entry {
+				QString text;
+				int confidence = -1;
+			};
+
+			static QSharedPointer<TesseractResultCache> forCollection(const QString& dirPath);
+			static QByteArray key(const QImage& img, const QRect& rect, const QString& engineKey);
+
+			bool find(const QByteArray& key, Entry& entry) const;
+			void insert(const QByteArray& key, const Entry& entry);
+
+			QString filePath() const;
+			int size() const;
+
+		private:
+			TesseractResultCache(const QString& filePath);
+			void load();
+
+			mutable QMutex mMutex;
+			QString mFilePath;
+			QFile mFile;
+			QHash<QByteArray, Entry> mEntries;
+	};
+
+	/// <summary>
+	/// Intermediate PAGE files of a page that is being recognized.
+	/// The page is written to <xml>.part every few regions so that
+	/// a crash or timeout does not lose the regions recognized so far.
+	/// The next run resumes from the checkpoint (regions with text are skipped).
+	/// NOTE: each checkpoint rewrites the whole page, so n regions cost
+	/// O(n^2 / interval) I/O - checkpoints are off by default (CheckpointInterval)
+	/// and meant for very large pages that might time out. Pages without
+	/// an input PAGE XML (processPage) are recognized in one call and
+	/// have no checkpoints.
+	/// </summary>
+	class TesseractCheckpoint {
+
+		public:
+			TesseractCheckpoint(const QString& xmlPath = QString());
+
+			QSharedPointer<rdf::PageElement> resume(const QString& inputXmlPath = QString()) const;
+			void write(const QSharedPointer<rdf::PageElement> page) const;
+			void finish() const;
+
+			bool isEmpty() const;
+			QString filePath() const;
+
+		private:
+			QString mFilePath;
+	};
+
+	class TesseractEngine {
+
+		public:
+			TesseractEngine();
+			~TesseractEngine();
+
+			enum InputFormat {
+				input_native = 0,	// pass the QImage as is (typically 32 bit ARGB)
+				input_gray,			// 8 bit grayscale
+				input_binary,		// 1 bpp Pix (Otsu if the image is not binary already)
+
+				input_end
+			};
+
+			static QImage normalizeImage(const QImage& img, int format = input_gray);
+
+			bool init(const QString tessdataDir, const QString language = "eng", tesseract::OcrEngineMode oem = tesseract::OEM_DEFAULT);
+			void clear();
+			QString key() const;
+
+			void setCache(QSharedPointer<TesseractResultCache> cache);
+			tesseract::ResultIterator* processPage(const QImage img);
+			QImage processTextRegions(QImage img, QVector<QSharedPointer<rdf::Region>> textRegions, bool parallel = false);
+			void recognizeTextRegions(const QImage& img, const QVector<QSharedPointer<rdf::Region>>& textRegions, bool parallel = false);
+			QImage getRegionImage(const QImage img, const QSharedPointer<rdf::Region>, const QColor fillColor = QColor(Qt::white)) const;
+			void addTextToRegion(const QImage img, QSharedPointer<rdf::Region> region, 
+				const rdf::Rect regionRect = rdf::Rect(), const tesseract::PageSegMode psm = tesseract::PageSegMode::PSM_AUTO);
+			rdf::Rect polygonToOCRBox(const QSize imgSize, const rdf::Polygon poly) const;
+
+			static QVector<QSharedPointer<rdf::Region>> extractTextRegions(const QSharedPointer<rdf::PageElement> xmlPage);
+			static QImage drawRegions(const QImage& img, const QVector<QSharedPointer<rdf::Region>>& textRegions);
+
+			static void routeTextRegions(const QImage& img, const QSharedPointer<rdf::PageElement> xmlPage, const QVector<QSharedPointer<rdf::Region>>& textRegions, 
+				const TesseractPluginConfig& config, QSharedPointer<TesseractResultCache> cache = QSharedPointer<TesseractResultCache>(), 
+				const TesseractCheckpoint& checkpoint = TesseractCheckpoint());
+			static QMap<QString, QVector<QSharedPointer<rdf::Region>>> routeByLanguage(const QSharedPointer<rdf::PageElement> xmlPage, 
+				const QVector<QSharedPointer<rdf::Region>>& textRegions, const QStringList& languages);
+			static QString regionLanguage(const QSharedPointer<rdf::Region> region);
+
+			static QString key(const QString& tessdataDir, const QString& language, tesseract::OcrEngineMode oem);
+
+		private:
+			tesseract::TessBaseAPI* mTessAPI;
+			QString mKey;
+			QSharedPointer<TesseractResultCache> mCache;
+			QString mTessdataDir;
+			QString mLanguage;
+			tesseract::OcrEngineMode mOem = tesseract::OEM_DEFAULT;
+			qint64 mImageKey = 0;	// QImage::cacheKey() of the image tesseract holds (0 = none)
+
+			void recognizeRegions(const QImage& img, const QVector<QSharedPointer<rdf::Region>>& textRegions);
+			TesseractResultCache::Entry recognize(const QImage& img, const rdf::Rect& regionRect, const tesseract::PageSegMode psm);
+			static void setRegionText(QSharedPointer<rdf::Region> region, const QString& text);
+			void setImage(const QImage img);
+			void setRectangle(const rdf::Rect rect);
+			bool isAARect(rdf::Polygon poly);
+	};
+
+	/// <summary>
+	/// Keeps initialized tesseract engines for the lifetime of the plugin.
+	/// Loading the traineddata takes longer than recognizing a short page, so engines
+	/// (keyed by tessdata dir, language and OEM) are handed out per page and cleared
+	/// instead of ended when the last reference is released.
+	/// </summary>
+	class TesseractEnginePool {
+
+		public:
+			static TesseractEnginePool& instance();
+
+			QSharedPointer<TesseractEngine> acquire(const QString& tessdataDir, const QString& language = "eng", tesseract::OcrEngineMode oem = tesseract::OEM_DEFAULT);
+			QSharedPointer<TesseractEngine> acquire(const TesseractPluginConfig& config);
+			void clear();
+
+		private:
+			TesseractEnginePool();
+			~TesseractEnginePool();
+			TesseractEnginePool(const TesseractEnginePool&) = delete;
+			TesseractEnginePool& operator=(const TesseractEnginePool&) = delete;
+
+			void release(TesseractEngine* engine);
+
+			QMutex mMutex;
+			QMultiHash<QString, TesseractEngine*> mIdle;
+			int mMaxIdle;		// idle engines kept per key - set in the ctor
+	};
+
+	/// <summary>
+	/// Converts tesseract's page results to PAGE regions.
+	/// textLevel is the finest level that is exported:
+	/// 0 (block), 1 (paragraph), 2 (line), 3 (word)
+	/// If confidences are enabled, each region gets tesseract's
+	/// confidence as PAGE custom attribute.
+	/// </summary>
+	class TesseractPageConverter {
+
+		public:
+			TesseractPageConverter(int textLevel = 2, bool singleLevelOutput = false);
+
+			void setConfidences(bool confidences);
+
+			void convert(tesseract::ResultIterator * ri, const QSharedPointer<rdf::PageElement> xmlPage) const;
+
+			static QString stripBraces(const QString& id);
+
+		private:
+			int mTextLevel = 2;
+			bool mSingleLevelOutput = false;
+			bool mConfidences = false;
+
+			void convertRegions(const tesseract::PageIteratorLevel fil, tesseract::ResultIterator* ri, QSharedPointer<rdf::Region> root) const;
+			QString confidenceTag(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel level) const;
+			QSharedPointer<rdf::TextRegion> createTextRegion(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel level, 
+				const tesseract::PageIteratorLevel outputLevel, bool textAtAllLevels = false) const;
+			QSharedPointer<rdf::TextLine> createTextLine(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel outputLevel, 
+				bool textAtAllLevels = false) const;
+	};
+
+};
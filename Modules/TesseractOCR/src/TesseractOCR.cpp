@@ -43,6 +43,11 @@ related links:
 #include "Utils.h"
 #include "Drawer.h"
 
+// ReadModules
+#include "PageXmlCache.h"
+#include "ImageBridge.h"
+#include "Telemetry.h"
+
 //tesseract
 #include <allheaders.h> // leptonica main header for image io
 
@@ -52,6 +57,7 @@ related links:
 
 #pragma warning(push, 0)	// no warnings from includes - begin
 #include <QAction>
+#include <QFileInfo>
 #include <QSettings>
 #include <QUuid>
 #pragma warning(pop)		// no warnings from includes - end
@@ -157,6 +163,7 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 	if (!imgC)
 		return imgC;
 
+	TelemetryPage tp(imgC->filePath());
 
 	if (runID == mRunIDs[id_perform_ocr]) {
 
@@ -180,37 +187,49 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 		//get currrent image
 		QImage img = imgC->image();
 
-		// load existing XML or create new one
+		QString saveXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.outputFilePath());
+		TesseractCheckpoint checkpoint(mConfig.checkpointInterval() > 0 ? saveXmlPath : QString());
+
+		// resume an interrupted run, load existing XML or create new one
 		QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.inputFilePath());
-		rdf::PageXmlParser parser;
-		bool xml_found = parser.read(loadXmlPath);
+		bool xml_found = false;
+		auto xmlPage = checkpoint.resume(loadXmlPath);
+
+		if (xmlPage)
+			xml_found = true;
+		else
+			xmlPage = PageXmlCache::instance().read(loadXmlPath, &xml_found);
 
 		// set xml header info
-		auto xmlPage = parser.page();
 		xmlPage->setCreator(QString("CVL"));
 		xmlPage->setImageSize(QSize(img.size()));
 		xmlPage->setImageFileName(imgC->fileName());
 
-		// init tesseract
-		TesseractEngine tessEngine;
-		bool initialized = tessEngine.init(mConfig.TessdataDir());
+		// convert once - tesseract works on gray (or binary) images anyway
+		QImage ocrImg = TesseractEngine::normalizeImage(img, mConfig.inputFormat());
 
-		if (!initialized)
-			return imgC;
-		
 		if (!xml_found) {
 			
 			qInfo() << "Tesseract plugin: OCR on current image";
 			rdf::Timer dt;
 
+			// get an initialized engine - it is returned to the pool when we are done with this page
+			QSharedPointer<TesseractEngine> tessEngine = TesseractEnginePool::instance().acquire(mConfig);
+
+			if (!tessEngine)
+				return imgC;
+
 			// compute tesseract OCR results
 			tesseract::ResultIterator* pageResults;
-			pageResults = tessEngine.processPage(img);
+			pageResults = tessEngine->processPage(ocrImg);
 
 			qInfo() << "Tesseract plugin: Finished computing tessract results.";
 
 			// convert results to PAGE xml regions
-			convertPageResults(pageResults, xmlPage);
+			TesseractPageConverter converter(mConfig.textLevel(), mConfig.singleLevelOutput());
+			converter.setConfidences(mConfig.confidences());
+			converter.convert(pageResults, xmlPage);
+			delete pageResults;
 
 			qInfo() << "Tesseract plugin: Successfully converted results to PAGE xml.";
 			qInfo() << "Tesseract plugin: OCR results computed in" << dt;
@@ -220,9 +239,14 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 			qInfo() << "Tesseract plugin: OCR on current image - using existing PAGE xml";
 			rdf::Timer dt;
 
+			// reuse the results of regions that did not change since the last run
+			QSharedPointer<TesseractResultCache> cache;
+			if (mConfig.resultCache())
+				cache = TesseractResultCache::forCollection(QFileInfo(saveXmlPath).absolutePath());
+
 			// extract list of text regions that should be processed by tesseract
-			QVector<QSharedPointer<rdf::Region>> textRegions = extractTextRegions(xmlPage);
-			QImage result = tessEngine.processTextRegions(img, textRegions);
+			QVector<QSharedPointer<rdf::Region>> textRegions = TesseractEngine::extractTextRegions(xmlPage);
+			TesseractEngine::routeTextRegions(ocrImg, xmlPage, textRegions, mConfig, cache, checkpoint);
 			
 			qInfo() << "Tesseract plugin: OCR results computed in" << dt;
 
@@ -230,20 +254,20 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 			if (mConfig.drawResults()) {
 
 				qDebug() << "Tesseract plugin: Drawing OCR boxes that have been recognized.";
-				imgC->setImage(result, "OCR boxes");
+				imgC->setImage(TesseractEngine::drawRegions(ocrImg, textRegions), "OCR boxes");
 			}
 		}
 		
 		// write xml output
-		QString saveXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.outputFilePath());
-		parser.write(saveXmlPath, xmlPage);
+		PageXmlCache::instance().write(saveXmlPath, xmlPage);
+		checkpoint.finish();
 	}
 
 	if (runID == mRunIDs[id_white_space_analysis]) {
 
 		//get currrent imagescale
 		QImage img = imgC->image();
-		cv::Mat imgCv = nmc::DkImage::qImage2Mat(img);
+		MatView imgCv(img);
 
 		rdf::WhiteSpaceAnalysis wsa(imgCv);
 		
@@ -257,11 +281,9 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 		
 		// load existing XML or create new one
 		QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(saveInfo.inputFilePath());
-		rdf::PageXmlParser parser;
-		bool xml_found = parser.read(loadXmlPath);
+		auto xmlPage = PageXmlCache::instance().read(loadXmlPath);
 
 		// set xml header info
-		auto xmlPage = parser.page();
 		xmlPage->setCreator(QString("CVL"));
 		xmlPage->setImageSize(QSize(img.size()));
 		xmlPage->setImageFileName(imgC->fileName());
@@ -277,7 +299,7 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 		for (auto tr : wsa.evalTextBlockRegions()) {
 			xmlPage->rootRegion()->addChild(tr);
 		}
-		parser.write(saveXmlPath, xmlPage);
+		PageXmlCache::instance().write(saveXmlPath, xmlPage);
 
 		////add text line results to page and save as xml
 		//xmlPage->rootRegion()->removeAllChildren();
@@ -298,7 +320,7 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 
 		// drawing debug image
 		if (mConfig.drawResults()) {
-			QImage result = rdf::Image::mat2QImage(wsa.draw(imgCv), true);
+			QImage result = ImageBridge::toQImage(wsa.draw(imgCv));
 			qDebug() << "Tesseract plugin: Drawing white segmentation results.";
 			imgC->setImage(result, "visualising white space based layout segmentation");
 		}
@@ -308,7 +330,7 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 
 		//get currrent imagescale
 		QImage img = imgC->image();
-		cv::Mat imgCv = rdf::Image::qImage2Mat(img);
+		MatView imgCv(img);
 
 		qDebug() << "Running text height estimation test...";
 
@@ -325,7 +347,7 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 		}
 
 		if (mConfig.drawResults()) {
-			QImage result = rdf::Image::mat2QImage(the.draw(imgCv), true);
+			QImage result = ImageBridge::toQImage(the.draw(imgCv));
 			qInfo() << "Tesseract plugin: Drawing text height estimation results.";
 			imgC->setImage(result, "visualising text height estimation results");
 		}
@@ -335,388 +357,6 @@ QSharedPointer<nmc::DkImageContainer> TesseractPlugin::runPlugin(
 	return imgC;
 }
 
-// OCR related functions------------------------------------------------------------------------------
-
-void TesseractPlugin::convertPageResults(tesseract::ResultIterator* pageResults, const QSharedPointer<rdf::PageElement> xmlPage) const {
-
-	int ol = mConfig.textLevel();
-
-	if (ol < 0 || ol>3) {
-		ol = 1;
-		qWarning() << "Tesseract plugin: TextLevel has to be an Integer from 0-3: 0(block), 1(paragraph), 2(line), 3(word))";
-		qInfo() << "Tesseract plugin: TextLevel set to 1.";
-	}
-
-	tesseract::PageIteratorLevel outputLevel = static_cast<tesseract::PageIteratorLevel>(ol);
-	tesseract::PageIteratorLevel currentLevel = tesseract::RIL_BLOCK;
-
-	convertRegion(currentLevel, outputLevel, pageResults, xmlPage->rootRegion());
-
-	if (mConfig.singleLevelOutput()) {
-		QVector<QSharedPointer<rdf::Region>> regions;
-
-		if (ol == 2) {
-			regions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_line);
-		}
-		else if (ol == 3) {
-			regions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_word);
-		}
-		else {
-			regions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_region);
-		}
-
-		if (!regions.isEmpty()){
-			xmlPage->rootRegion()->removeAllChildren();
-			for (QSharedPointer<rdf::Region> c : regions) {
-				if (c->children().isEmpty()) {	// do not add RIL_BLOCK elements
-					xmlPage->rootRegion()->addChild(c);
-				}
-			}
-		}
-	}
-}
-
-void TesseractPlugin::convertRegion(const tesseract::PageIteratorLevel cil, const tesseract::PageIteratorLevel fil, tesseract::ResultIterator* ri, QSharedPointer<rdf::Region> parent) const {
-
-	if (!ri->Empty(cil)) {
-		if (PTIsTextType(ri->BlockType())) {
-			if (cil <= fil) {
-
-				QSharedPointer<rdf::Region> child;
-
-				if (ri->IsAtBeginningOf(cil)) {
-
-					if (cil == tesseract::RIL_TEXTLINE) {
-						child = createTextLine(ri, fil);
-					}
-					else {
-						child = createTextRegion(ri, cil, fil);
-					}
-
-					//process text regions of the current child
-					convertRegion(static_cast<tesseract::PageIteratorLevel>(cil + 1), fil, ri, child);
-					parent->addChild(child);
-				}
-
-				if (cil != tesseract::RIL_BLOCK) {
-					if (ri->IsAtFinalElement(static_cast<tesseract::PageIteratorLevel>(cil - 1), cil)) {
-						return;
-					}
-				}
-
-				if (ri->Next(cil)) {
-					convertRegion(cil, fil, ri, parent);
-				}
-			}
-			else {
-				//qDebug() << "Reached final iterator level!";
-				return;
-			}
-		}
-		else {
-			//qDebug() << "Found a non text block!";
-			ri->Next(tesseract::RIL_BLOCK);
-			convertRegion(cil, fil, ri, parent);
-		}
-	}
-	//qDebug() << "Finished processing text regions!";
-	return;
-}
-
-QSharedPointer<rdf::TextRegion> TesseractPlugin::createTextRegion(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel riLevel, 
-	const tesseract::PageIteratorLevel outputLevel, bool textAtAllLevels) const {
-
-	// TODO find a more general way to create all kinds of text region in one function
-
-	//create text region element
-	QSharedPointer<rdf::TextRegion> textRegion(new rdf::TextRegion());
-
-	int x1, y1, x2, y2;
-	ri->BoundingBox(riLevel, &x1, &y1, &x2, &y2);
-	rdf::Rect r(QRect(QPoint(x1, y1), QPoint(x2, y2)));
-	textRegion->setPolygon(rdf::Polygon::fromRect(r));
-	
-	if (riLevel == outputLevel || textAtAllLevels) {
-		char* text = ri->GetUTF8Text(riLevel);
-		//qDebug("new block found: %s", text);
-		textRegion->setText(QString::fromUtf8(text));
-		delete[] text;
-	}
-
-	textRegion->setId(textRegion->id().remove("{").remove("}"));	// remove parentheses to please Aletheia and avoid errors
-
-	if (riLevel == tesseract::PageIteratorLevel::RIL_WORD) {
-		textRegion->setType(rdf::Region::type_word);
-	}
-
-	//if (riLevel == tesseract::RIL_WORD) {
-		// NOTE word font attributes currently not available for tess 4.0 LSTM mode
-
-		// TODO test if legacy engine provides font attributes while maintaining recognition performance of lstm
-		//float wConfidence = ri->Confidence(riLevel);
-		//qDebug() << "Word recognition confidence = " << wConfidence;
-
-		//bool* is_bold = false;
-		//bool* is_italic = false;
-		//bool* is_underlined = false;
-		//bool* is_monospace = false;
-		//bool* is_serif = false;
-		//bool* is_smallcaps = false;
-		//int* pointsize = 0;
-		//int* font_id = 0;
-
-		//ri->WordFontAttributes(is_bold, is_italic, is_underlined, is_monospace, is_serif, is_smallcaps, pointsize, font_id);
-		//
-		//qDebug() << "Word Font Attributes: " << is_bold << ", " << is_italic  << ", " << is_underlined << ", " << is_monospace << ", " << is_serif << ", " << is_smallcaps << ", " << pointsize << ", " << font_id << ", " << wConfidence;
-		
-	//}
-
-	return textRegion;
-}
-
-QSharedPointer<rdf::TextLine> TesseractPlugin::createTextLine(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel outputLevel, bool textAtAllLevels) const {
-
-	//create text region element
-	QSharedPointer<rdf::TextLine> textLine(new rdf::TextLine());
-
-	int x1, y1, x2, y2;
-	ri->BoundingBox(tesseract::RIL_TEXTLINE, &x1, &y1, &x2, &y2);
-	rdf::Rect r(QRect(QPoint(x1, y1), QPoint(x2, y2)));
-	textLine->setPolygon(rdf::Polygon::fromRect(r));
-
-	if (outputLevel == tesseract::RIL_TEXTLINE || textAtAllLevels) {
-		char* text = ri->GetUTF8Text(tesseract::RIL_TEXTLINE);
-		//qDebug("new block found: %s", text);
-		textLine->setText(QString::fromUtf8(text));
-		delete[] text;
-	}
-
-	textLine->setId(textLine->id().remove("{").remove("}"));	// remove parentheses to please Aletheia and avoid errors
-
-	return textLine;
-}
-
-// extract text region containing no text results
-QVector<QSharedPointer<rdf::Region>> TesseractPlugin::extractTextRegions(const QSharedPointer<rdf::PageElement> xmlPage) const {
-
-	// get text regions from existing xml (type_text_region + type_text_line)
-	QVector<QSharedPointer<rdf::Region>> tRegions = rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_region);
-	tRegions = tRegions + rdf::Region::filter(xmlPage->rootRegion().data(), rdf::Region::type_text_line);
-	
-	QVector<QSharedPointer<rdf::Region>> emptyTextRegions;
-
-	for (auto r : tRegions) {
-
-		if (!r->isEmpty() && !r->polygon().isEmpty()) {
-
-			if (r->type() == rdf::Region::type_text_region) {
-				auto trc = qSharedPointerCast<rdf::TextRegion>(r);
-				if (trc->text().isEmpty()) {
-					emptyTextRegions.append(r);
-				}
-			}
-			else if (r->type() == rdf::Region::type_text_line) {
-				auto trc = qSharedPointerCast<rdf::TextLine>(r);
-				if (trc->text().isEmpty()) {
-					emptyTextRegions.append(r);
-				}
-			}
-		}
-	}
-
-	qWarning() << "Tesseract plugin: Found" << emptyTextRegions.size() << "empty text regions where text recognition results will be added.";
-
-	return emptyTextRegions;
-}
-
-// TesseractEngine functions--------------------------------------------------------------------------
-
-TesseractEngine::TesseractEngine() {	
-	mTessAPI = new tesseract::TessBaseAPI();
-}
-
-TesseractEngine::~TesseractEngine() {
-	mTessAPI->End();
-	qDebug() << "Tesseract plugin: destroying tesseract engine...";
-}
-
-bool TesseractEngine::init(const QString tessdataDir) {
-
-	// TODO allow different languages
-	char * lang = "eng";
-	
-	qInfo() << "Using tesseract version " << mTessAPI->Version();
-	if (mTessAPI->Init(tessdataDir.toStdString().c_str(), lang)==-1){
-		qWarning() << "Tesseract plugin: Could not initialize tesseract API!";
-		qWarning() << "Tesseract plugin: Set path to tessdata folder using config plugin!";
-		qWarning() << "Tesseract plugin: If tessdata folder is missing, create it and download eng.traineddata from github https:\\\\github.com\\tesseract-ocr\\tessdata";
-		return false;
-	}
-	else {
-		qInfo() << "Tesseract plugin: Initialized tesseract API.";
-		qInfo() << "Tesseract plugin: Using tesseract version: " << mTessAPI->Version();
-		
-		tesseract::OcrEngineMode cOEM =  mTessAPI->oem();
-		qInfo() << "Tesseract plugin: Using OCR engine mode: " << cOEM;
-	}
-
-	return true;
-}
-
-void TesseractEngine::setImage(const QImage img) {	
-	mTessAPI->SetImage(img.bits(), img.width(), img.height(), img.bytesPerLine() / img.width(), img.bytesPerLine());
-}
-
-void TesseractEngine::setRectangle(const rdf::Rect rect) {
-
-	mTessAPI->SetRectangle((int)rect.topLeft().x(), (int)rect.topLeft().y(), (int)rect.width(), (int)rect.height());
-}
-
-tesseract::ResultIterator* TesseractEngine::processPage(const QImage img) {
-	setImage(img);
-
-	//set tess parameters
-	mTessAPI->SetPageSegMode(tesseract::PageSegMode::PSM_AUTO);
-	mTessAPI->SetVariable("save_best_choices", "T");
-	mTessAPI->Recognize(0);
-
-	tesseract::ResultIterator* ri = mTessAPI->GetIterator();
-
-	return ri;
-}
-
-QImage TesseractEngine::processTextRegions(QImage img, QVector<QSharedPointer<rdf::Region>> textRegions){
-
-	// TODO fix coloring of drawn items
-	QImage result = img.copy();
-	QPainter myPainter(&result);
-	myPainter.setPen(QPen(QBrush(rdf::ColorManager::blue()), 3));
-	myPainter.setBrush(Qt::NoBrush);
-
-	for (auto r : textRegions) {
-		
-		if (r.isNull()) {
-			continue;
-		}
-
-		// removes isNull() points from polygon - rdf::Rect::fromPoints() method also ignores them
-		//QPolygon poly = r->polygon().polygon().toPolygon();
-		//for (QPoint p : poly) {
-		//	if (p.isNull())
-		//		poly.removeOne(p);
-		//}
-		//r->polygon().setPolygon(QPolygonF(poly));
-		//r->setPolygon(rdf::Polygon(QPolygonF(poly)));
-
-		if (isAARect(r->polygon())) {
-			rdf::Rect rRect = polygonToOCRBox(img.size(), r->polygon());
-			addTextToRegion(img, r, rRect);
-		}
-		else {
-			QImage rImg = getRegionImage(img, r);
-			addTextToRegion(rImg, r);
-		}
-		
-
-		rdf::Rect rR = polygonToOCRBox(img.size(), r->polygon());
-		myPainter.drawPolyline(r->polygon().closedPolygon().begin(), r->polygon().closedPolygon().size());
-	}
-
-	myPainter.end();
-
-	return result;
-}
-
-void TesseractEngine::addTextToRegion(const QImage img, QSharedPointer<rdf::Region> region, const rdf::Rect regionRect, const tesseract::PageSegMode psm) {
-
-	// set rect region and do OCR
-	setImage(img);
-
-	if (!regionRect.isNull()) {
-		setRectangle(regionRect);
-	}
-
-	mTessAPI->SetPageSegMode(psm);
-	mTessAPI->SetVariable("save_best_choices", "T");
-
-	mTessAPI->Recognize(0);
-	char* boxText = mTessAPI->GetUTF8Text();
-
-	//write text to regions
-	auto r = region;
-	if (r->type() == rdf::Region::type_text_region) {
-		auto rc = qSharedPointerCast<rdf::TextRegion>(r);
-		rc->setText(QString::fromUtf8(boxText));
-	}
-	else if (r->type() == rdf::Region::type_text_line) {
-		auto rc = qSharedPointerCast<rdf::TextLine>(r);
-		rc->setText(QString::fromUtf8(boxText));
-	}
-
-	delete[] boxText;
-
-}
-
-// get a cropped and masked image of the text region
-QImage TesseractEngine::getRegionImage(const QImage img, const QSharedPointer<rdf::Region> region, const QColor fillColor) const {
-
-	// check for axis aligned rect
-	
-	// TODO test results and find out if there is a better method for masking a polygonal area	
-	// TODO check why img.format() results in black background sometimes
-	QImage regionImg = QImage(img.size(), QImage::Format_RGB32);
-	regionImg.fill(fillColor);
-
-	QPainter myPainter(&regionImg);
-
-	myPainter.setClipRegion(QRegion(region->polygon().polygon().toPolygon()));
-	myPainter.drawImage(0, 0, img);
-
-	rdf::Rect regionRect = polygonToOCRBox(img.size(), region->polygon());	//this will add some additional padding
-	QImage croppedRI = regionImg.copy(regionRect.toQRect());
-
-	// debug ocr images
-	//cv::Mat cri = rdf::Image::qImage2Mat(croppedRI);
-	//cv::Mat ri = rdf::Image::qImage2Mat(regionImg);
-	
-	return croppedRI;
-}
-
-rdf::Rect TesseractEngine::polygonToOCRBox(const QSize imgSize, const rdf::Polygon poly) const {
-
-	rdf::Rect ocrBox = rdf::Rect::fromPoints(poly.toPoints());		// warning: fromPoints ignores point (0,0)
-	ocrBox.expand(10); // expanding image improves OCR results - avoids errors if text is connected to the image border
-	ocrBox = ocrBox.clipped(rdf::Vector2D(imgSize));
-
-	return ocrBox;
-}
-
-// returns true if polygon is an axis aligned rectangle
-bool TesseractEngine::isAARect(rdf::Polygon poly) {
-
-	// TODO test/debug function
-	
-	if (poly.size() == 4) {
-
-		QVector<rdf::Vector2D> pts;
-
-		for (const QPointF& p : poly.polygon()) {
-			pts << rdf::Vector2D(p);
-		}
-
-		rdf::Vector2D l1 = pts[0] - pts[1];
-		rdf::Vector2D l2 = pts[2] - pts[3];
-		
-		if (l1.length() == l2.length())
-			return true;
-		else
-			return false;
-	}
-	else {
-		return false;
-	}
-}
-
 // plugin functions----------------------------------------------------------------------------------
 void TesseractPlugin::preLoadPlugin() const {
 
@@ -724,6 +364,12 @@ void TesseractPlugin::preLoadPlugin() const {
 }
 
 void TesseractPlugin::postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo>>& batchInfo) const {
+
+	Telemetry::instance().flush();
+
+	if (batchInfo.empty())
+		return;
+
 	int runIdx = mRunIDs.indexOf(batchInfo.first()->id());
 
 	for (auto bi : batchInfo) {
@@ -760,53 +406,4 @@ void TesseractPlugin::saveSettings(QSettings & settings) const {
 	settings.endGroup();
 }
 
-// tesseract config---------------------------------------------------------------------------
-TesseractPluginConfig::TesseractPluginConfig() : ModuleConfig("TesseractPlugin") {
-}
-
-void TesseractPluginConfig::load(const QSettings & settings) {
-
-	mTessdataDir = settings.value("TessdataDir", mTessdataDir).toString();
-	mTextLevel = settings.value("TextLevel", mTextLevel).toInt();
-	mDrawResults = settings.value("DrawResults", mDrawResults).toBool();
-	mSingleLevelOutput = settings.value("SingleLevelOutput", mSingleLevelOutput).toBool();
-}
-
-void TesseractPluginConfig::save(QSettings & settings) const {
-
-	settings.setValue("TessdataDir", mTessdataDir);
-	settings.setValue("TextLevel", mTextLevel);
-	settings.setValue("DrawResults", mDrawResults);
-	settings.setValue("SingleLevelOutput", mSingleLevelOutput);
-}
-
-QString TesseractPluginConfig::TessdataDir() const {
-	return mTessdataDir;
-}
-
-int TesseractPluginConfig::textLevel() const {
-	return mTextLevel;
-}
-
-bool TesseractPluginConfig::drawResults() const {
-	return mDrawResults;
-}
-
-bool TesseractPluginConfig::singleLevelOutput() const {
-	return mSingleLevelOutput;
-}
-
-QString TesseractPluginConfig::toString() const {
-
-	QString msg = rdf::ModuleConfig::toString();
-	msg += "  TessdataDir: " + mTessdataDir;
-	msg += "  TextLevel: " + QString::number(mTextLevel);
-	msg += drawResults() ? " drawing results\n" : " not drawing results\n";
-	msg += singleLevelOutput() ? " single text level exported\n" : " all text levels exported\n";
-
-	return msg;
-}
-
 };
-
-
@@ -44,8 +44,7 @@ related links:
 #include "WhiteSpaceAnalysis.h"
 #include "TextHeightEstimation.h"
 
-//tesseract includes
-#include <baseapi.h> // tesseract main header
+#include "TesseractEngine.h"
 
 // opencv defines
 namespace cv {
@@ -58,56 +57,6 @@ namespace rdf {
 
 namespace rdm {
 
-	class TesseractPluginConfig : public rdf::ModuleConfig {
-
-		public:
-			TesseractPluginConfig();
-
-			virtual QString toString() const override;
-
-			QString TessdataDir() const;
-			//void setTessdataDir(QString dir);
-
-			int textLevel() const;
-			//void setTextLevel(int level);
-
-			bool drawResults() const;
-
-			bool singleLevelOutput() const;
-			//void setDrawResults(bool draw);
-
-		private:
-
-			QString mTessdataDir = QString("E:\\dev\\CVL\\ReadModules\\ReadModules\\Modules\\TesseractOCR");
-			int mTextLevel = 2;
-			bool mDrawResults = false;
-			bool mSingleLevelOutput = false;
-
-			void load(const QSettings& settings) override;
-			void save(QSettings& settings) const override;
-	};
-
-	class TesseractEngine {
-
-		public:
-			TesseractEngine();
-			~TesseractEngine();
-
-			bool init(const QString tessdataDir);
-			tesseract::ResultIterator* processPage(const QImage img);
-			QImage processTextRegions(QImage img, QVector<QSharedPointer<rdf::Region>> textRegions);
-			QImage getRegionImage(const QImage img, const QSharedPointer<rdf::Region>, const QColor fillColor = QColor(Qt::white)) const;
-			void addTextToRegion(const QImage img, QSharedPointer<rdf::Region> region, 
-				const rdf::Rect regionRect = rdf::Rect(), const tesseract::PageSegMode psm = tesseract::PageSegMode::PSM_AUTO);
-			rdf::Rect polygonToOCRBox(const QSize imgSize, const rdf::Polygon poly) const;
-
-		private:
-			tesseract::TessBaseAPI* mTessAPI;
-			void setImage(const QImage img);
-			void setRectangle(const rdf::Rect rect);
-			bool isAARect(rdf::Polygon poly);
-	};
-
 	class TesseractPlugin : public QObject, nmc::DkBatchPluginInterface {
 		Q_OBJECT
 			Q_INTERFACES(nmc::DkBatchPluginInterface)
@@ -152,14 +101,6 @@ namespace rdm {
 		rdf::WhiteSpaceAnalysisConfig mWsaConfig;
 		rdf::TextHeightEstimationConfig mTheConfig;
 		QString mModuleName;
-
-		void convertPageResults(tesseract::ResultIterator * ri, const QSharedPointer<rdf::PageElement> xmlPage) const;
-		QVector<QSharedPointer<rdf::Region>> extractTextRegions(const QSharedPointer<rdf::PageElement> xmlPage) const;
-		void convertRegion(const tesseract::PageIteratorLevel cil, const tesseract::PageIteratorLevel fil, tesseract::ResultIterator* ri, QSharedPointer<rdf::Region> parent) const;
-		QSharedPointer<rdf::TextRegion> createTextRegion(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel level, 
-			const tesseract::PageIteratorLevel outputLevel, bool textAtAllLevels = false) const;
-		QSharedPointer<rdf::TextLine> createTextLine(const tesseract::ResultIterator* ri, const tesseract::PageIteratorLevel outputLevel, 
-			bool textAtAllLevels = false) const;
 	};
 
 };
@@ -40,6 +40,10 @@
 #include "Utils.h"
 #include "Algorithms.h"
 
+// ReadModules
+#include "PageXmlCache.h"
+#include "Telemetry.h"
+
 #pragma warning(push, 0)	// no warnings from includes - begin
 #include <QAction>
 #include <QSettings>
@@ -155,6 +159,8 @@ QSharedPointer<nmc::DkImageContainer> WriterIdentificationPlugin::runPlugin(
 	if (!imgC)
 		return imgC;
 
+	TelemetryPage tp(imgC->filePath());
+
 	if(runID == mRunIDs[id_calcuate_features]) {
 		qInfo() << "calculating features for writer identification";
 		rdf::WriterImage wi = rdf::WriterImage();
@@ -172,9 +178,7 @@ QSharedPointer<nmc::DkImageContainer> WriterIdentificationPlugin::runPlugin(
 
 		QString loadXmlPath = rdf::PageXmlParser::imagePathToXmlPath(imgC->filePath());
 		if(QFileInfo(loadXmlPath).exists()) {
-			rdf::PageXmlParser parser;
-			parser.read(loadXmlPath);
-			auto pe = parser.page();
+			auto pe = PageXmlCache::instance().read(loadXmlPath, 0, true);
 
 			QVector<QSharedPointer<rdf::Region>> regs = pe->rootRegion()->allRegions();
 			for(auto i : regs) {
@@ -191,7 +195,10 @@ QSharedPointer<nmc::DkImageContainer> WriterIdentificationPlugin::runPlugin(
 			wi.setMask(cMaskC1);
 		}
 		wi.setImage(imgCv);
-		wi.calculateFeatures();
+		{
+			ScopedSpan span("writer/calculateFeatures");
+			wi.calculateFeatures();
+		}
 		cv::cvtColor(imgCv, imgCv, CV_RGB2GRAY);
 		qDebug() << "lenght:" << wi.keyPoints().size();
 		QVector<cv::KeyPoint> kp = wi.keyPoints();
@@ -372,6 +379,8 @@ void WriterIdentificationPlugin::preLoadPlugin() const {
 void WriterIdentificationPlugin::postLoadPlugin(const QVector<QSharedPointer<nmc::DkBatchInfo> >& batchInfo) const {
 	qDebug() << "postLoadPlugin";
 
+	Telemetry::instance().flush();
+
 	if(batchInfo.empty())
 		return;
 
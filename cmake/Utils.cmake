@@ -1,3 +1,6 @@
+# root of the ReadModules sources (Utils.cmake is included by every plugin)
+get_filename_component(RDM_ROOT_DIRECTORY "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+
 # Searches for Qt with the required components
 macro(RDM_FIND_QT)
 
@@ -15,7 +18,7 @@ macro(RDM_FIND_QT)
 	GET_FILENAME_COMPONENT(QT_QMAKE_PATH ${QT_QMAKE_EXECUTABLE} PATH)
 	set(QT_ROOT ${QT_QMAKE_PATH}/)
 	SET(CMAKE_PREFIX_PATH ${CMAKE_PREFIX_PATH} ${QT_QMAKE_PATH}\\..\\lib\\cmake\\Qt5)
-	find_package(Qt5 REQUIRED Core Network Widgets LinguistTools)
+	find_package(Qt5 REQUIRED Core Network Widgets Concurrent LinguistTools)
 	if (NOT Qt5_FOUND)
 		message(FATAL_ERROR "Qt5 not found. Check your QT_QMAKE_EXECUTABLE path and set it to the correct location")
 	endif()
@@ -191,3 +194,11 @@ macro(RDM_GENERATE_USER_FILE)
 		endif()
 	endif(MSVC)
 endmacro(RDM_GENERATE_USER_FILE)
+
+# links the shared module core (Modules/Core) to the current plugin
+macro(RDM_LINK_CORE)
+	if(NOT TARGET ReadModulesCore)
+		add_subdirectory(${RDM_ROOT_DIRECTORY}/Modules/Core ${CMAKE_BINARY_DIR}/ReadModulesCore)
+	endif()
+	target_link_libraries(${PROJECT_NAME} ReadModulesCore)
+endmacro(RDM_LINK_CORE)